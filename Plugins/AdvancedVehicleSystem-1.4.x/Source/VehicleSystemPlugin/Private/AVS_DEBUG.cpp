@@ -5,6 +5,27 @@
 
 DEFINE_LOG_CATEGORY(LogAVS);
 
+DEFINE_STAT(STAT_AVS_PhysicsStep);
+DEFINE_STAT(STAT_AVS_GatherQueries);
+DEFINE_STAT(STAT_AVS_WheelTraces);
+DEFINE_STAT(STAT_AVS_PhysicsTick);
+DEFINE_STAT(STAT_AVS_Contacts);
+DEFINE_STAT(STAT_AVS_Suspension);
+DEFINE_STAT(STAT_AVS_Friction);
+DEFINE_STAT(STAT_AVS_ApplyForces);
+DEFINE_STAT(STAT_AVS_AlwaysTick);
+DEFINE_STAT(STAT_AVS_MarshalIn);
+DEFINE_STAT(STAT_AVS_MarshalOut);
+DEFINE_STAT(STAT_AVS_WheelVisuals);
+DEFINE_STAT(STAT_AVS_NetReceive);
+DEFINE_STAT(STAT_AVS_NetInterpolate);
+DEFINE_STAT(STAT_AVS_ActiveVehicles);
+DEFINE_STAT(STAT_AVS_PassiveVehicles);
+DEFINE_STAT(STAT_AVS_SimulatedVehicles);
+DEFINE_STAT(STAT_AVS_TracesPerStep);
+DEFINE_STAT(STAT_AVS_StatesQueued);
+DEFINE_STAT(STAT_AVS_StatesDropped);
+
 void UAVS_DEBUG::LOG(EDebugCategory DebugCategory, const FString& FinalString)
 {
 	#if AVS_DEBUG
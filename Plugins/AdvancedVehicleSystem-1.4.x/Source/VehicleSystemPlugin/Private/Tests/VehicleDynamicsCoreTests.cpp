@@ -0,0 +1,113 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehicleDynamicsCore.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAVS_DynamicsCoreRegressionTest, "AVS.DynamicsCore.MatchesInlineSlipModel",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAVS_DynamicsCoreRegressionTest::RunTest(const FString& Parameters)
+{
+	// Driven, braking, handbrake locked and reversing wheels
+	struct FLane
+	{
+		float TraceDistance; float CompressionVelocity; float ImpactTilt;
+		float Inertia; float BrakeTorque; float RollingResistance; FVector2D Friction;
+		float RollingVelocity; FVector2D ContactVelocityM; float ContactSpeedM; float SlipAngle;
+		float Throttle; float Brake; float DriveTorque; bool Locked;
+	};
+	const FLane Lanes[] =
+	{
+		{ 75.0f,  0.3f, 0.9f, 0.675f, 2500.0f, 0.01f, FVector2D(1.4f, 1.2f),  1200.0f, FVector2D(12.0f,  0.5f), 12.01f,  2.5f, 1.0f, 0.0f,  4.0f, false },
+		{ 68.0f, -0.2f, 1.0f, 0.675f, 2500.0f, 0.01f, FVector2D(1.4f, 1.4f),  -300.0f, FVector2D(-3.0f,  1.5f),  3.35f, -8.0f, 0.0f, 0.6f,  0.0f, false },
+		{ 62.0f,  0.5f, 0.8f, 0.9f,   1500.0f, 0.02f, FVector2D(1.1f, 1.0f),  2500.0f, FVector2D(25.0f, -2.0f), 25.08f,  4.0f, 0.3f, 0.0f,  0.0f, true },
+		{ 80.0f,  0.0f, 0.3f, 0.5f,   2000.0f, 0.05f, FVector2D(1.4f, 1.4f),    50.0f, FVector2D(0.5f,   0.2f),  0.54f,  1.0f, 0.5f, 0.0f, -1.5f, false },
+	};
+
+	// Results of the slip code that lived inline in AVS_PhysicsTick before it moved into FAVS_DynamicsCore, after three steps at 60Hz.
+	// A change here is a change to how every raycast wheel drives
+	struct FExpected { float SuspensionForce; float SlipX; float SlipY; float AngularVelocity; float TractionX; float TractionY; };
+	const FExpected Expected[] =
+	{
+		{ 2800.0f,  0.318878f,  0.208333f,  40.0f,      0.446429f,  0.547723f },
+		{ 4050.0f,  0.881834f, -0.666667f, -10.0f,      1.116776f, -1.087196f },
+		{ 6250.0f, -1.0f,       0.333333f,   0.0f,     -1.043552f,  0.562341f },
+		{ 625.0f,  -0.947972f, -0.856279f,   1.666667f, -1.038918f, -1.146211f },
+	};
+	constexpr int32 NumLanes = UE_ARRAY_COUNT(Lanes);
+
+	FAVS_WheelKernelData Data;
+	TArray<FAVS_WheelSlipInput> SlipInputs;
+	for( const FLane& Lane : Lanes )
+	{
+		const int32 Index = Data.AddLane(Data.Num());
+		Data.TraceDistances[Index] = Lane.TraceDistance;
+		Data.SpringLengths[Index] = 25.0f;
+		Data.Radii[Index] = 30.0f;
+		Data.SpringStrengths[Index] = 25.0f;
+		Data.SpringDampings[Index] = 1.0f;
+		Data.CompressionVelocities[Index] = Lane.CompressionVelocity;
+		Data.ImpactTilts[Index] = Lane.ImpactTilt;
+
+		FAVS_WheelSlipInput& Input = SlipInputs.AddDefaulted_GetRef();
+		Input.DeltaTime = 1.0f / 60.0f;
+		Input.WheelRadius = 30.0f;
+		Input.Inertia = Lane.Inertia;
+		Input.BrakeTorque = Lane.BrakeTorque;
+		Input.RollingResistance = Lane.RollingResistance;
+		Input.Friction = Lane.Friction;
+		Input.RollingVelocity = Lane.RollingVelocity;
+		Input.ContactVelocityM = Lane.ContactVelocityM;
+		Input.ContactSpeedM = Lane.ContactSpeedM;
+		Input.SlipAngle = Lane.SlipAngle;
+		Input.Throttle = Lane.Throttle;
+		Input.Brake = Lane.Brake;
+		Input.DriveTorque = Lane.DriveTorque;
+		Input.Locked = Lane.Locked;
+	}
+	Data.PadToGroupWidth();
+
+	TArray<FVector2D> Slips;
+	Slips.Init(FVector2D::ZeroVector, NumLanes);
+	TArray<float> AngularVelocities;
+	AngularVelocities.Init(0.0f, NumLanes);
+	for( int32 Step = 0; Step < 3; ++Step )
+	{
+		FAVS_DynamicsCore::StepWheels(Data, 150.0f, SlipInputs, Slips, AngularVelocities);
+	}
+
+	// Kernel validation tolerance, the vector traction path may be the one running
+	auto TestValue = [this](const TCHAR* Name, int32 Lane, float Actual, float ExpectedValue)
+	{
+		TestTrue(FString::Printf(TEXT("%s lane %d (expected %f, got %f)"), Name, Lane, ExpectedValue, Actual), FAVS_WheelKernel::ValuesMatch(ExpectedValue, Actual));
+	};
+	for( int32 Lane = 0; Lane < NumLanes; ++Lane )
+	{
+		TestValue(TEXT("SuspensionForces"), Lane, Data.SuspensionForces[Lane], Expected[Lane].SuspensionForce);
+		TestValue(TEXT("Slip X"), Lane, Slips[Lane].X, Expected[Lane].SlipX);
+		TestValue(TEXT("Slip Y"), Lane, Slips[Lane].Y, Expected[Lane].SlipY);
+		TestValue(TEXT("AngularVelocities"), Lane, AngularVelocities[Lane], Expected[Lane].AngularVelocity);
+		TestValue(TEXT("TractionsX"), Lane, Data.TractionsX[Lane], Expected[Lane].TractionX);
+		TestValue(TEXT("TractionsY"), Lane, Data.TractionsY[Lane], Expected[Lane].TractionY);
+	}
+
+	// One substep has to stay the plain StepSlip
+	FVector2D SubstepSlip = FVector2D::ZeroVector;
+	FVector2D PlainSlip = FVector2D::ZeroVector;
+	float SubstepAngularVelocity = 0.0f;
+	float PlainAngularVelocity = 0.0f;
+	FVector2D AverageSlip;
+	FAVS_WheelSlipInput Input = SlipInputs[0];
+	Input.SuspensionForceN = Expected[0].SuspensionForce;
+	FAVS_DynamicsCore::StepSlipSubsteps(Input, 1, SubstepSlip, SubstepAngularVelocity, AverageSlip);
+	FAVS_DynamicsCore::StepSlip(Input, PlainSlip, PlainAngularVelocity);
+	TestTrue(TEXT("Single substep slip"), SubstepSlip.Equals(PlainSlip, 0.0));
+	TestEqual(TEXT("Single substep angular velocity"), SubstepAngularVelocity, PlainAngularVelocity);
+	TestTrue(TEXT("Single substep average slip"), AverageSlip.Equals(PlainSlip, 0.0));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,114 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehiclePhysicsCallback.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAVS_PhysicsOutputPoolTest, "AVS.PhysicsOutput.PooledBuffersDoNotGrow",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAVS_PhysicsOutputPoolTest::RunTest(const FString& Parameters)
+{
+	// Vehicles with different wheel counts. The solver hands the callback its pooled outputs round robin,
+	// the game thread pops the ones written since the last frame and hands them out with FAVS_LatestPhysicsOutput::HandOut
+	const int32 WheelCounts[] = { 4, 6, 2 };
+	constexpr int32 NumVehicles = UE_ARRAY_COUNT(WheelCounts);
+	TArray<TUniquePtr<FVehiclePhysicsPhysicsOutput>> Pool;
+	for( int32 Index = 0; Index < 3; ++Index )
+	{
+		Pool.Add(MakeUnique<FVehiclePhysicsPhysicsOutput>());
+	}
+	TArray<FAVS_LatestPhysicsOutput> Latest; // LatestPhysicsOutput of each vehicle
+	Latest.SetNum(NumVehicles);
+
+	int32 PoolIndex = 0;
+	auto RunFrame = [&](uint64 Frame)
+	{
+		// Some frames get two physics steps, each written the way AVS_PhysicsTick fills its entry
+		const int32 NumSteps = (Frame % 3 == 0) ? 2 : 1;
+		TArray<int32, TInlineAllocator<2>> Slots;
+		TArray<TUniquePtr<FVehiclePhysicsPhysicsOutput>, TInlineAllocator<2>> Popped;
+		for( int32 Step = 0; Step < NumSteps; ++Step )
+		{
+			TUniquePtr<FVehiclePhysicsPhysicsOutput>& Output = Pool[PoolIndex];
+			Slots.Add(PoolIndex);
+			PoolIndex = (PoolIndex + 1) % Pool.Num();
+
+			Output->Reset();
+			Output->ChaosDeltaTime = 1.0f / 60.0f;
+			for( int32 VIndex = 0; VIndex < NumVehicles; ++VIndex )
+			{
+				FAVS_VehiclePhysicsOutput& VehicleOutput = Output->Vehicles[Output->AddVehicle(nullptr)];
+				VehicleOutput.WheelConfigVersion = VIndex; // Tells the vehicles apart, there are no actors here
+				VehicleOutput.WheelOutputs.SetNum(WheelCounts[VIndex]);
+				VehicleOutput.DebugForces.AddDefaulted(WheelCounts[VIndex]);
+			}
+			Popped.Add(MoveTemp(Output));
+		}
+
+		FAVS_LatestPhysicsOutput::HandOut(MakeArrayView(Popped), Frame, [&Latest](const FAVS_VehiclePhysicsOutput& VehicleOutput)
+		{
+			return &Latest[VehicleOutput.WheelConfigVersion];
+		});
+
+		// Back to the pool, in the slots they were taken from
+		for( int32 Step = 0; Step < NumSteps; ++Step )
+		{
+			Pool[Slots[Step]] = MoveTemp(Popped[Step]);
+		}
+	};
+
+	// Every buffer owned by the pool or the vehicles, the same set once warmed up means nothing was allocated or freed
+	auto GetBuffers = [&Pool, &Latest]()
+	{
+		TArray<const void*> Buffers;
+		auto AddVehicleBuffers = [&Buffers](const FAVS_VehiclePhysicsOutput& VehicleOutput)
+		{
+			Buffers.Add(VehicleOutput.WheelOutputs.GetData());
+			Buffers.Add(VehicleOutput.DebugForces.GetData());
+		};
+		for( const TUniquePtr<FVehiclePhysicsPhysicsOutput>& Output : Pool )
+		{
+			Buffers.Add(Output->Vehicles.GetData());
+			for( const FAVS_VehiclePhysicsOutput& VehicleOutput : Output->Vehicles )
+			{
+				AddVehicleBuffers(VehicleOutput);
+			}
+		}
+		for( const FAVS_LatestPhysicsOutput& VehicleOutput : Latest )
+		{
+			AddVehicleBuffers(VehicleOutput);
+		}
+		Buffers.Sort();
+		return Buffers;
+	};
+
+	// Warm up until every pooled output and every vehicle has sized its buffers
+	uint64 Frame = 1;
+	for( ; Frame < 2 * Pool.Num() + 2; ++Frame )
+	{
+		RunFrame(Frame);
+	}
+
+	const TArray<const void*> WarmedUpBuffers = GetBuffers();
+	for( ; Frame < 200; ++Frame )
+	{
+		RunFrame(Frame);
+		if( GetBuffers() != WarmedUpBuffers )
+		{
+			AddError(FString::Printf(TEXT("Output buffers were reallocated on frame %llu"), Frame));
+			break;
+		}
+	}
+
+	for( int32 VIndex = 0; VIndex < NumVehicles; ++VIndex )
+	{
+		TestEqual(FString::Printf(TEXT("Vehicle %d wheel outputs"), VIndex), Latest[VIndex].WheelOutputs.Num(), WheelCounts[VIndex]);
+		TestTrue(FString::Printf(TEXT("Vehicle %d received on the last frame"), VIndex), Latest[VIndex].Frame == Frame - 1);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,73 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehicleWheelKernel.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAVS_WheelKernelParityTest, "AVS.WheelKernel.ScalarVectorParity",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAVS_WheelKernelParityTest::RunTest(const FString& Parameters)
+{
+	// Fixed lanes covering a hanging wheel, normal travel, excess compression, tilt falloff and slip inside and outside the friction circle
+	struct FLane { float TraceDistance; float CompressionVelocity; float ImpactTilt; float SlipX; float SlipY; };
+	const FLane Lanes[] =
+	{
+		{ 95.0f,  0.0f, 1.0f,   0.0f,  0.0f },
+		{ 75.0f,  0.3f, 0.9f,   0.3f, -0.2f },
+		{ 68.0f, -0.2f, 0.3f,   1.5f,  0.8f },
+		{ 58.0f,  0.5f, 1.0f,  -0.4f,  0.9f },
+		{ 60.0f, -1.0f, 0.05f,  0.0f, -1.0f },
+		{ 82.0f,  0.1f, 0.5f,   2.0f,  0.0f },
+	};
+
+	FAVS_WheelKernelData ScalarData;
+	for( const FLane& Input : Lanes )
+	{
+		const int32 Lane = ScalarData.AddLane(ScalarData.Num());
+		ScalarData.TraceDistances[Lane] = Input.TraceDistance;
+		ScalarData.SpringLengths[Lane] = 25.0f;
+		ScalarData.Radii[Lane] = 30.0f;
+		ScalarData.SpringStrengths[Lane] = 25.0f;
+		ScalarData.SpringDampings[Lane] = 1.0f;
+		ScalarData.CompressionVelocities[Lane] = Input.CompressionVelocity;
+		ScalarData.ImpactTilts[Lane] = Input.ImpactTilt;
+		ScalarData.SlipsX[Lane] = Input.SlipX;
+		ScalarData.SlipsY[Lane] = Input.SlipY;
+		ScalarData.FrictionsX[Lane] = 1.4f;
+		ScalarData.FrictionsY[Lane] = 1.2f;
+	}
+	ScalarData.PadToGroupWidth();
+
+	constexpr float AntiGravityN = 150.0f;
+	FAVS_WheelKernelData VectorData = ScalarData;
+	TestEqual(TEXT("Lanes are padded to the group width"), ScalarData.Num() % FAVS_WheelKernelData::GroupWidth, 0);
+
+	FAVS_WheelKernel::SuspensionScalar(ScalarData, AntiGravityN);
+	FAVS_WheelKernel::SuspensionVector(VectorData, AntiGravityN);
+	FAVS_WheelKernel::TractionScalar(ScalarData);
+	FAVS_WheelKernel::TractionVector(VectorData);
+
+	for( int32 Lane = 0; Lane < ScalarData.Num(); ++Lane )
+	{
+		auto TestColumn = [this, Lane](const TCHAR* Column, const TArray<float>& Scalar, const TArray<float>& Vector)
+		{
+			TestTrue(FString::Printf(TEXT("%s lane %d (scalar %f, vector %f)"), Column, Lane, Scalar[Lane], Vector[Lane]), FAVS_WheelKernel::ValuesMatch(Scalar[Lane], Vector[Lane]));
+		};
+		TestColumn(TEXT("CurrentSpringLengths"), ScalarData.CurrentSpringLengths, VectorData.CurrentSpringLengths);
+		TestColumn(TEXT("SuspensionForces"), ScalarData.SuspensionForces, VectorData.SuspensionForces);
+		TestColumn(TEXT("TractionsX"), ScalarData.TractionsX, VectorData.TractionsX);
+		TestColumn(TEXT("TractionsY"), ScalarData.TractionsY, VectorData.TractionsY);
+
+		if( ScalarData.WheelIndices[Lane] == INDEX_NONE )
+		{
+			TestEqual(FString::Printf(TEXT("Padding lane %d has no suspension force"), Lane), VectorData.SuspensionForces[Lane], 0.0f);
+			TestEqual(FString::Printf(TEXT("Padding lane %d has no traction"), Lane), VectorData.TractionsX[Lane] + VectorData.TractionsY[Lane], 0.0f);
+		}
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
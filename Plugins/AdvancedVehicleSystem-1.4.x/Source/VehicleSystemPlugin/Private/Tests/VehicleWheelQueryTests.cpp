@@ -0,0 +1,85 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehicleWheelQuery.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAVS_WheelQueryProfileRaysTest, "AVS.WheelQuery.ProfileRays",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAVS_WheelQueryProfileRaysTest::RunTest(const FString& Parameters)
+{
+	UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if( !TestNotNull(TEXT("Engine cube mesh"), Cube) )
+		return false;
+
+	// Game world with its own physics scene, Execute traces it like a vehicle's world
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	// Static 100cm cubes scaled into boxes, placed by their top face
+	auto SpawnBox = [World, Cube](const FVector& TopCenter, const FVector& Size)
+	{
+		const FTransform Transform(FQuat::Identity, TopCenter - FVector(0.0f, 0.0f, Size.Z * 0.5f), Size / 100.0f);
+		AStaticMeshActor* Box = World->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform);
+		Box->GetStaticMeshComponent()->SetStaticMesh(Cube);
+		Box->GetStaticMeshComponent()->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		Box->FinishSpawning(Transform);
+		World->Tick(LEVELTICK_All, 1.0f / 60.0f); // Lets the scene query structure pick up the new body
+		return Box;
+	};
+	SpawnBox(FVector::ZeroVector, FVector(1000.0f, 1000.0f, 100.0f));
+
+	// 35cm wheel with 25cm of travel, centered 40cm above the ground
+	const float Radius = 35.0f;
+	const float TraceHalfLength = 25.0f * 0.5f + Radius;
+	const FVector WheelLocation(0.0f, 0.0f, 40.0f);
+	const FVector TraceStart = WheelLocation + FVector::UpVector * TraceHalfLength;
+	const FVector TraceEnd = WheelLocation - FVector::UpVector * TraceHalfLength;
+
+	FAVS_WheelQueryBatch SingleRay;
+	SingleRay.AddRay(TraceStart, TraceEnd, ECC_Vehicle, nullptr);
+	SingleRay.Execute(World);
+	TestTrue(TEXT("Single ray hits the ground"), SingleRay.GetHit(0).bBlockingHit);
+	const float SingleDistance = SingleRay.GetHit(0).Distance;
+	TestEqual(TEXT("Single ray distance"), SingleDistance, float(TraceStart.Z), 0.01f);
+
+	// Curb under the front ray only, it reaches the tire once it is higher than the tire's profile there
+	const float FrontOffset = Radius * 0.7f;
+	const float ProfileHeight = Radius - FMath::Sqrt(Radius*Radius - FrontOffset*FrontOffset);
+	for( const float CurbHeight : {0.0f, ProfileHeight * 0.5f, ProfileHeight + 5.0f} )
+	{
+		AStaticMeshActor* Curb = (CurbHeight > 0.0f) ? SpawnBox(FVector(FrontOffset + 24.0f, 0.0f, CurbHeight), FVector(50.0f, 100.0f, CurbHeight + 10.0f)) : nullptr;
+		for( int32 NumRays : {3, 5, 9} )
+		{
+			// Flat ground has to give the same suspension length as a single ray
+			FAVS_WheelQueryBatch MultiRay;
+			const int32 FirstIndex = MultiRay.AddProfileRays(TraceStart, TraceEnd, FVector::ForwardVector, Radius, 0.7f, NumRays, ECC_Vehicle, nullptr);
+			MultiRay.Execute(World);
+			const float Expected = (CurbHeight > ProfileHeight) ? SingleDistance - (CurbHeight - ProfileHeight) : SingleDistance;
+			TestEqual(FString::Printf(TEXT("%d rays with a %.1fcm curb"), NumRays, CurbHeight), MultiRay.GetClosestHit(FirstIndex, NumRays).Distance, Expected, 0.01f);
+		}
+		if( Curb != nullptr )
+		{
+			Curb->Destroy();
+			World->Tick(LEVELTICK_All, 1.0f / 60.0f);
+		}
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
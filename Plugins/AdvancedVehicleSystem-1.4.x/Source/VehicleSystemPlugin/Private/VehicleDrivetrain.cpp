@@ -0,0 +1,82 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehicleDrivetrain.h"
+
+float FAVS_Drivetrain::StepEngine(const FAVS_DrivetrainConfig& Config, FAVS_DrivetrainState& State, float ForwardSpeed, float Throttle, float DeltaTime)
+{
+	const int32 NumGears = Config.Gears.Num();
+	if( NumGears == 0 )
+	{
+		State = FAVS_DrivetrainState();
+		return 0.0f;
+	}
+
+	const float Speed = FMath::Abs(ForwardSpeed) * Config.SpeedScale;
+	State.Gear = FMath::Clamp(State.Gear, 0, NumGears - 1);
+
+	// Automatic transmission, a shift point of 0 is never used
+	if( State.ShiftTimer <= 0.0f )
+	{
+		const FVehicleGear& Gear = Config.Gears[State.Gear];
+		if( State.Gear < NumGears - 1 && Gear.UpShift > 0.0f && Speed > Gear.UpShift )
+		{
+			++State.Gear;
+			State.ShiftTimer = Config.ShiftTime;
+		}
+		else if( State.Gear > 0 && Gear.DownShift > 0.0f && Speed < Gear.DownShift )
+		{
+			--State.Gear;
+			State.ShiftTimer = Config.ShiftTime;
+		}
+	}
+
+	// Torque and RPM move from the Start to the End of the gear's speed range
+	const FVehicleGear& Gear = Config.Gears[State.Gear];
+	const float Alpha = Gear.EndSpeed > Gear.StartSpeed ? FMath::Clamp((Speed - Gear.StartSpeed) / (Gear.EndSpeed - Gear.StartSpeed), 0.0f, 1.0f) : 0.0f;
+	State.EngineRPM = FMath::Lerp(Gear.LowRPM, Gear.HighRPM, Alpha);
+
+	if( State.ShiftTimer > 0.0f )
+	{
+		State.ShiftTimer -= DeltaTime;
+		return 0.0f; // Clutch is open
+	}
+	if( State.Gear == NumGears - 1 && Speed >= Gear.EndSpeed )
+	{
+		return 0.0f; // Rev limiter
+	}
+
+	const float Torque = FMath::Lerp(Gear.MaxTorque, Gear.MinTorque, Alpha) * Config.GetTorqueMultiplier(State.EngineRPM);
+	return Torque * FMath::Clamp(Throttle, 0.0f, 1.0f);
+}
+
+void FAVS_Drivetrain::SplitTorque(const FAVS_DrivetrainConfig& Config, float TotalTorque, TConstArrayView<float> Grips, TArrayView<float> OutTorques)
+{
+	check(Grips.Num() == OutTorques.Num());
+	const int32 NumWheels = Grips.Num();
+	if( NumWheels == 0 )
+		return;
+
+	const float EqualShare = TotalTorque / NumWheels;
+	float GripSum = 0.0f;
+	for( const float Grip : Grips )
+	{
+		GripSum += Grip;
+	}
+
+	// Open, or nothing to lock against
+	if( Config.Differential == EVehicleDifferential::Open || GripSum <= UE_SMALL_NUMBER )
+	{
+		for( float& Torque : OutTorques )
+		{
+			Torque = EqualShare;
+		}
+		return;
+	}
+
+	const float Locking = FMath::Clamp(Config.LimitedSlipLocking, 0.0f, 1.0f);
+	for( int32 Index = 0; Index < NumWheels; ++Index )
+	{
+		OutTorques[Index] = EqualShare * (1.0f - Locking) + TotalTorque * Locking * (Grips[Index] / GripSum);
+	}
+}
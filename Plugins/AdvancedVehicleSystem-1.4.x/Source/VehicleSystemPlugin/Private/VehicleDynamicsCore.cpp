@@ -0,0 +1,233 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehicleDynamicsCore.h"
+
+#include "AVS_DEBUG.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+	// Find SlipY Target :: Simply Lerp from LowSpeedSlip -> HighSpeedSlip
+	float GetLateralSlipTarget(const FAVS_WheelSlipInput& Input)
+	{
+		const float YSlipTargetHighSpeed = Input.SlipAngle / 12.0f; // SlipAngle / SlipAnglePeak
+		const float YSlipTargetLowSpeed = -FMath::Sign(Input.ContactVelocityM.Y);
+		const float Alpha = FMath::GetMappedRangeValueClamped(FVector2D(1.0f, 2.0f), FVector2D(0.0f, 1.0f), Input.ContactSpeedM);
+		return FMath::Lerp(YSlipTargetLowSpeed, YSlipTargetHighSpeed, Alpha);
+	}
+
+	// Interpolation of a substep covering Fraction of the step, the substeps together move as far towards a fixed target as one full step would
+	float GetSubstepInterpSpeed(float StepInterpSpeed, float Fraction)
+	{
+		return (StepInterpSpeed >= 1.0f) ? 1.0f : 1.0f - FMath::Pow(1.0f - StepInterpSpeed, Fraction);
+	}
+}
+
+void FAVS_DynamicsCore::StepSlip(const FAVS_WheelSlipInput& Input, FVector2D& InOutSlip, float& InOutAngularVelocity)
+{
+	const float ChaosDelta = Input.DeltaTime;
+	const FVector2D& WheelVelocityLocalM = Input.ContactVelocityM;
+
+	const float RollingAngVel = Input.RollingVelocity / Input.WheelRadius;
+	InOutAngularVelocity = RollingAngVel;
+	
+	// Find SlipX Target
+	float XSlipTarget = 0.0f;
+	if( Input.Locked ) // Wheel Locking
+	{
+		InOutAngularVelocity = 0.0f;
+		XSlipTarget = FMath::Sign(-WheelVelocityLocalM.X);
+	}
+	else
+	{
+		const float MaxFrictionTorque = Input.SuspensionForceN * (Input.WheelRadius * 0.01f) * Input.Friction.X; // SpringForce(N) * Radius(M) * Friction
+
+		float BrakeInput = FMath::Clamp(Input.Brake, Input.RollingResistance, 1.0f); // Clamp between Resistance & 1, RollingResistance can just be applied as brakes
+		//float XBrakeTorque = (0.0f - RollingAngVel) / ChaosDelta * Input.Inertia; XBrakeTorque *= BrakeInput;
+		float XBrakeTorque = FMath::Sign(InOutAngularVelocity * (-1.0f)) * Input.BrakeTorque * BrakeInput;
+
+		float XDriveTorqueNm = 0.0f;
+		if( Input.DriveTorque != 0.0f ) // Throttle
+		{
+			float NewAngVel = InOutAngularVelocity + ((Input.DriveTorque*100.0f) / Input.Inertia * ChaosDelta);
+
+			// Calculate the XSlip based on the new angular velocity
+			XDriveTorqueNm = (NewAngVel - RollingAngVel) / ChaosDelta * Input.Inertia;
+		}
+
+		float XFinalTorque = XBrakeTorque + XDriveTorqueNm; // TODO :: Create debug logger and figure out why this doesn't work
+		XSlipTarget = XFinalTorque / MaxFrictionTorque;
+	}
+
+	// Interpolate SlipX to target
+	float SlipX = InOutSlip.X; // Long Slip
+	const float MinInterpSpeed = FMath::Clamp(Input.Throttle * 0.1f, 0.01f, 0.1f);
+	const float InterpSpeedLong = Input.SnapSlip ? 1.0f : FMath::Clamp(FMath::Abs(WheelVelocityLocalM.X) / 0.010f * ChaosDelta, MinInterpSpeed, 1.0f);
+	SlipX += (XSlipTarget - SlipX) * InterpSpeedLong;
+	SlipX = FMath::Clamp(SlipX, -30.0f, 30.0f); // Long Slip Limit
+	
+	const float YSlipTarget = GetLateralSlipTarget(Input);
+	
+	// Interpolate SlipY to target
+	float SlipY = InOutSlip.Y; // Lat Slip
+	const float InterpSpeedLat = Input.SnapSlip ? 1.0f : FMath::Clamp(FMath::Abs(WheelVelocityLocalM.Y) / 0.007f * ChaosDelta, 0.0f, 1.0f);
+	SlipY += (YSlipTarget - SlipY) * InterpSpeedLat;
+
+	InOutSlip = FVector2D(SlipX, SlipY); // Actual slip, the traction kernel normalizes it for the final force
+}
+
+void FAVS_DynamicsCore::StepSlipSubsteps(const FAVS_WheelSlipInput& Input, int32 NumSubsteps, FVector2D& InOutSlip, float& InOutAngularVelocity, FVector2D& OutAverageSlip)
+{
+	if( NumSubsteps <= 1 )
+	{
+		StepSlip(Input, InOutSlip, InOutAngularVelocity);
+		OutAverageSlip = InOutSlip;
+		return;
+	}
+
+	const float StepDelta = Input.DeltaTime;
+	const float SubstepDelta = StepDelta / NumSubsteps;
+	const FVector2D& WheelVelocityLocalM = Input.ContactVelocityM;
+	const float RollingAngVel = Input.RollingVelocity / Input.WheelRadius;
+	const float MaxFrictionTorque = FMath::Max(Input.SuspensionForceN * (Input.WheelRadius * 0.01f) * Input.Friction.X, UE_KINDA_SMALL_NUMBER);
+	const float DriveTorque = Input.DriveTorque * 100.0f; // Same scale as StepSlip
+	const float BrakeTorque = Input.BrakeTorque * FMath::Clamp(Input.Brake, Input.RollingResistance, 1.0f);
+
+	// Same interpolation as StepSlip over the whole step, split between the substeps so the result does not depend on their count
+	const float MinInterpSpeed = FMath::Clamp(Input.Throttle * 0.1f, 0.01f, 0.1f);
+	const float InterpSpeedLong = Input.SnapSlip ? 1.0f : GetSubstepInterpSpeed(FMath::Clamp(FMath::Abs(WheelVelocityLocalM.X) / 0.010f * StepDelta, MinInterpSpeed, 1.0f), 1.0f / NumSubsteps);
+	const float InterpSpeedLat = Input.SnapSlip ? 1.0f : GetSubstepInterpSpeed(FMath::Clamp(FMath::Abs(WheelVelocityLocalM.Y) / 0.007f * StepDelta, 0.0f, 1.0f), 1.0f / NumSubsteps);
+	const float YSlipTarget = GetLateralSlipTarget(Input);
+
+	float AngVel = InOutAngularVelocity;
+	FVector2D Slip = InOutSlip;
+	FVector2D SlipSum = FVector2D::ZeroVector;
+	for( int32 Substep = 0; Substep < NumSubsteps; ++Substep )
+	{
+		float XSlipTarget = 0.0f;
+		if( Input.Locked ) // Wheel Locking
+		{
+			AngVel = 0.0f;
+			XSlipTarget = FMath::Sign(-WheelVelocityLocalM.X);
+		}
+		else
+		{
+			// The tire pushes back with the slip it carries right now, brakes slow the wheel down but never spin it the other way
+			const float TireTorque = -FMath::Clamp(Slip.X, -1.0f, 1.0f) * MaxFrictionTorque;
+			const float WheelBrakeTorque = -FMath::Sign(AngVel) * FMath::Min(BrakeTorque, FMath::Abs(AngVel) * Input.Inertia / SubstepDelta);
+			AngVel += (DriveTorque + WheelBrakeTorque + TireTorque) / Input.Inertia * SubstepDelta;
+
+			// Torque that would bring the wheel back to rolling speed over a step, settles on StepSlip's target of (drive + brake) / friction
+			XSlipTarget = (AngVel - RollingAngVel) / StepDelta * Input.Inertia / MaxFrictionTorque;
+		}
+
+		Slip.X = FMath::Clamp(Slip.X + (XSlipTarget - Slip.X) * InterpSpeedLong, -30.0f, 30.0f); // Long Slip Limit
+		Slip.Y += (YSlipTarget - Slip.Y) * InterpSpeedLat;
+		SlipSum += Slip;
+	}
+
+	InOutSlip = Slip;
+	InOutAngularVelocity = AngVel;
+	OutAverageSlip = SlipSum / NumSubsteps;
+}
+
+void FAVS_DynamicsCore::StepWheels(FAVS_WheelKernelData& Data, float AntiGravityN, TConstArrayView<FAVS_WheelSlipInput> SlipInputs,
+	TArrayView<FVector2D> Slips, TArrayView<float> AngularVelocities)
+{
+	check(SlipInputs.Num() <= Data.Num() && Slips.Num() == SlipInputs.Num() && AngularVelocities.Num() == SlipInputs.Num());
+
+	FAVS_WheelKernel::Suspension(Data, AntiGravityN);
+
+	for( int32 Lane = 0; Lane < SlipInputs.Num(); ++Lane )
+	{
+		FAVS_WheelSlipInput Input = SlipInputs[Lane];
+		Input.SuspensionForceN = Data.SuspensionForces[Lane];
+		StepSlip(Input, Slips[Lane], AngularVelocities[Lane]);
+
+		Data.SlipsX[Lane] = Slips[Lane].X;
+		Data.SlipsY[Lane] = Slips[Lane].Y;
+		Data.FrictionsX[Lane] = Input.Friction.X;
+		Data.FrictionsY[Lane] = Input.Friction.Y;
+	}
+
+	FAVS_WheelKernel::Traction(Data);
+}
+
+#if !UE_BUILD_SHIPPING
+double FAVS_DynamicsCore::Benchmark(int32 NumWheels, int32 NumSteps, uint32& OutChecksum)
+{
+	NumWheels = FMath::Max(NumWheels, 1);
+	NumSteps = FMath::Max(NumSteps, 1);
+
+	// Fixed seed so every run steps the same wheels
+	FRandomStream Random(1337);
+
+	FAVS_WheelKernelData Data;
+	TArray<FAVS_WheelSlipInput> SlipInputs;
+	for( int32 WIndex = 0; WIndex < NumWheels; ++WIndex )
+	{
+		const int32 Lane = Data.AddLane(WIndex);
+		Data.TraceDistances[Lane] = Random.FRandRange(50.0f, 90.0f);
+		Data.SpringLengths[Lane] = 25.0f;
+		Data.Radii[Lane] = 30.0f;
+		Data.SpringStrengths[Lane] = 25.0f;
+		Data.SpringDampings[Lane] = 1.0f;
+		Data.CompressionVelocities[Lane] = Random.FRandRange(-0.5f, 0.5f);
+		Data.ImpactTilts[Lane] = Random.FRandRange(0.8f, 1.0f);
+
+		FAVS_WheelSlipInput& Input = SlipInputs.AddDefaulted_GetRef();
+		Input.DeltaTime = 1.0f / 60.0f;
+		Input.Inertia = 0.5f * 15.0f * 0.3f * 0.3f;
+		Input.BrakeTorque = 2500.0f;
+		Input.RollingResistance = 0.01f;
+		Input.Friction = FVector2D(1.4f, 1.4f);
+		Input.RollingVelocity = Random.FRandRange(0.0f, 3000.0f);
+		Input.ContactVelocityM = FVector2D(Input.RollingVelocity * 0.01f, Random.FRandRange(-2.0f, 2.0f));
+		Input.ContactSpeedM = Input.ContactVelocityM.Size();
+		Input.SlipAngle = Random.FRandRange(-10.0f, 10.0f);
+		Input.Throttle = Random.FRand();
+		Input.DriveTorque = (WIndex % 2 == 0) ? Input.Throttle * 400.0f : 0.0f;
+	}
+	Data.PadToGroupWidth();
+
+	TArray<FVector2D> Slips;
+	Slips.Init(FVector2D::ZeroVector, NumWheels);
+	TArray<float> AngularVelocities;
+	AngularVelocities.Init(0.0f, NumWheels);
+
+	const double StartTime = FPlatformTime::Seconds();
+	for( int32 Step = 0; Step < NumSteps; ++Step )
+	{
+		StepWheels(Data, 150.0f, SlipInputs, Slips, AngularVelocities);
+	}
+	const double Elapsed = FPlatformTime::Seconds() - StartTime;
+
+	// Tuning changes show up as a different checksum for the same wheel/step count
+	OutChecksum = 0;
+	for( int32 Lane = 0; Lane < NumWheels; ++Lane )
+	{
+		OutChecksum = HashCombine(OutChecksum, GetTypeHash(Data.SuspensionForces[Lane]));
+		OutChecksum = HashCombine(OutChecksum, GetTypeHash(Data.TractionsX[Lane]));
+		OutChecksum = HashCombine(OutChecksum, GetTypeHash(Data.TractionsY[Lane]));
+		OutChecksum = HashCombine(OutChecksum, GetTypeHash(AngularVelocities[Lane]));
+	}
+
+	return (Elapsed * 1.e9) / (double(NumWheels) * double(NumSteps));
+}
+
+// Usage: avs.BenchmarkDynamics [Wheels=400] [Steps=1000], runs headless with -nullrhi -ExecCmds="avs.BenchmarkDynamics"
+static FAutoConsoleCommand GAVSBenchmarkDynamicsCommand(
+	TEXT("avs.BenchmarkDynamics"),
+	TEXT("Steps synthetic wheels through the vehicle dynamics core and logs ns per wheel step and a result checksum. Args: [Wheels] [Steps]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumWheels = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 400;
+		const int32 NumSteps = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 1000;
+
+		uint32 Checksum = 0;
+		const double NsPerWheelStep = FAVS_DynamicsCore::Benchmark(NumWheels, NumSteps, Checksum);
+		UE_LOG(LogAVS, Display, TEXT("avs.BenchmarkDynamics: %d wheels, %d steps, %.1f ns per wheel step, checksum %08x"), NumWheels, NumSteps, NsPerWheelStep, Checksum);
+	}));
+#endif
@@ -0,0 +1,86 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehicleForceAccumulator.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "PhysicsProxy/SingleParticlePhysicsProxy.h"
+
+Chaos::FRigidBodyHandle_Internal* FAVS_ForceAccumulator::GetRigidHandle(UPrimitiveComponent* Target)
+{
+	if( Target == nullptr )
+		return nullptr;
+
+	if( const FBodyInstance* BodyInstance = Target->GetBodyInstance() )
+	{
+		if( auto Handle = BodyInstance->ActorHandle )
+		{
+			return Handle->GetPhysicsThreadAPI();
+		}
+	}
+	return nullptr;
+}
+
+FAVS_ForceAccumulator::FBodyForce* FAVS_ForceAccumulator::FindOrAddBody(UPrimitiveComponent* Target)
+{
+	Chaos::FRigidBodyHandle_Internal* RigidHandle = GetRigidHandle(Target);
+	if( RigidHandle == nullptr )
+		return nullptr;
+
+	// Only the vehicle and its physics wheels end up here, a linear search is faster than a map
+	for( FBodyForce& Body : Bodies )
+	{
+		if( Body.Body == RigidHandle )
+			return &Body;
+	}
+
+	FBodyForce& NewBody = Bodies.AddDefaulted_GetRef();
+	NewBody.Body = RigidHandle;
+	return &NewBody;
+}
+
+void FAVS_ForceAccumulator::AddForce(UPrimitiveComponent* Target, const FVector& Force)
+{
+	if( FBodyForce* Body = FindOrAddBody(Target) )
+	{
+		Body->Force += Force;
+	}
+}
+
+void FAVS_ForceAccumulator::AddForceAtLocation(UPrimitiveComponent* Target, const FVector& Location, const FVector& Force)
+{
+	if( FBodyForce* Body = FindOrAddBody(Target) )
+	{
+		const Chaos::FVec3 WorldCOM = Chaos::FParticleUtilitiesGT::GetCoMWorldPosition(Body->Body);
+		Body->Force += Force;
+		Body->Torque += Chaos::FVec3::CrossProduct(Location - WorldCOM, Force);
+	}
+}
+
+void FAVS_ForceAccumulator::AddBrakeTorque(UPrimitiveComponent* Target, float BrakeTorque, float ChaosDelta)
+{
+	if( FBodyForce* Body = FindOrAddBody(Target) )
+	{
+		Chaos::FRigidBodyHandle_Internal* RigidHandle = Body->Body;
+		FTransform TargetWorldTransform(RigidHandle->R(), RigidHandle->X());
+
+		Chaos::FVec3 AngVel = RigidHandle->W();
+		Chaos::FVec3 FullStopTorque = (AngVel / ChaosDelta)*(-1.0f);
+
+		Chaos::FVec3 FullStopTorqueLocal = TargetWorldTransform.InverseTransformVectorNoScale(FullStopTorque); // Convert to local space
+		FullStopTorqueLocal *= Chaos::FVec3::RightVector; // Isolate the Y rotation
+
+		Chaos::FVec3 FullStopTorqueY = RigidHandle->R().RotateVector(FullStopTorqueLocal); // Convert back to world space
+		Chaos::FVec3 FinalBrakeForce = FullStopTorqueY.GetClampedToMaxSize(BrakeTorque); // Clamp to input brake force, if full stop exceeds brake force, wheel will only be slowed
+		Body->Torque += Chaos::FParticleUtilitiesXR::GetWorldInertia(RigidHandle) * FinalBrakeForce;
+	}
+}
+
+void FAVS_ForceAccumulator::Apply() const
+{
+	for( const FBodyForce& Body : Bodies )
+	{
+		Body.Body->AddForce(Body.Force, false);
+		Body.Body->AddTorque(Body.Torque, false);
+	}
+}
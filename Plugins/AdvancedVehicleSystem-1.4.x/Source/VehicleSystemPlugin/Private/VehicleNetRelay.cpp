@@ -0,0 +1,81 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehicleNetRelay.h"
+
+#include "GameFramework/PlayerController.h"
+
+UVehicleNetRelay::UVehicleNetRelay()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+}
+
+UVehicleNetRelay* UVehicleNetRelay::FindOrAddRelay(APlayerController* PlayerController)
+{
+	if( !IsValid(PlayerController) )
+		return nullptr;
+
+	UVehicleNetRelay* Relay = PlayerController->FindComponentByClass<UVehicleNetRelay>();
+	if( Relay == nullptr && PlayerController->HasAuthority() )
+	{
+		Relay = NewObject<UVehicleNetRelay>(PlayerController);
+		Relay->RegisterComponent();
+	}
+	return Relay;
+}
+
+void UVehicleNetRelay::RelayState(AVehicleSystemBase* Vehicle, const FNetState& State)
+{
+	APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	if( PlayerController == nullptr || !IsValid(Vehicle) )
+		return;
+
+	// Same relevancy the actor channel uses, no point sending states for a vehicle this player does not have
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+	if( !Vehicle->IsNetRelevantFor(PlayerController, PlayerController->GetViewTarget(), ViewLocation) )
+		return;
+
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	float* LastSendTime = LastSendTimes.Find(Vehicle);
+	if( LastSendTime == nullptr )
+	{
+		// New vehicle for this player, drop vehicles that have been destroyed since
+		for( auto It = LastSendTimes.CreateIterator(); It; ++It )
+		{
+			if( !It.Key().IsValid() ) It.RemoveCurrent();
+		}
+		LastSendTime = &LastSendTimes.Add(Vehicle, -UE_BIG_NUMBER);
+	}
+
+	// Half a send period of slack so timer jitter does not skip every other state at full rate
+	const float Interval = GetSendInterval(Vehicle, ViewLocation, ViewRotation);
+	if( CurrentTime - *LastSendTime < Interval - Vehicle->NetSendRate * 0.5f )
+		return;
+
+	*LastSendTime = CurrentTime;
+	Client_ReceiveVehicleState(Vehicle, State);
+}
+
+float UVehicleNetRelay::GetSendInterval(const AVehicleSystemBase* Vehicle, const FVector& ViewLocation, const FRotator& ViewRotation) const
+{
+	const FVector ToVehicle = Vehicle->GetActorLocation() - ViewLocation;
+	float DistanceMeters = ToVehicle.Size() * 0.01f;
+	if( FVector::DotProduct(ViewRotation.Vector(), ToVehicle) < 0.0f )
+	{
+		DistanceMeters *= Vehicle->NetSendLODOutOfViewScale; // Behind the camera
+	}
+
+	const float RateMultiplier = FMath::Max(1.0f, Vehicle->NetSendLODCurve.GetRichCurveConst()->Eval(DistanceMeters, 1.0f));
+	return Vehicle->NetSendRate * RateMultiplier;
+}
+
+void UVehicleNetRelay::Client_ReceiveVehicleState_Implementation(AVehicleSystemBase* Vehicle, FNetState State)
+{
+	if( IsValid(Vehicle) ) // Null if the vehicle has not replicated to this client yet
+	{
+		Vehicle->Client_ReceiveNetState_Implementation(State);
+	}
+}
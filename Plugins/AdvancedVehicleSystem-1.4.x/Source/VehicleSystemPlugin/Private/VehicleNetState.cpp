@@ -0,0 +1,327 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehicleSystemBase.h"
+
+#include "AVS_DEBUG.h"
+
+namespace AVS_NetState
+{
+	// Timestamp is sent in 10ms steps and wraps every 40.96 seconds
+	constexpr int32 TimestampBits = 12;
+	constexpr float TimestampStep = 0.01f;
+	constexpr float TimestampPeriod = TimestampStep * (1 << TimestampBits);
+
+	// Every precision covers the same 2.6km cell, positions outside cell 0 also send the packed cell index.
+	// Cells are centred on multiples of CellSize so a level around the origin stays in cell 0 on both sides of it
+	constexpr double CellSize = 262144.0;
+	constexpr double HalfCellSize = CellSize * 0.5;
+
+	struct FPrecisionInfo
+	{
+		int32 PositionBits;
+		float PositionStep;	// cm
+		int32 RotationBits;	// per smallest-three component
+		int32 VelocityBits;
+		float VelocityStep;	// cm/s
+		int32 AngularBits;
+		float AngularStep;	// deg/s
+	};
+
+	static const FPrecisionInfo PrecisionInfos[] =
+	{
+		{ 16, 4.0f, 8, 10, 20.0f, 9, 4.0f },		// Low
+		{ 17, 2.0f, 9, 11, 10.0f, 10, 2.0f },		// Medium
+		{ 18, 1.0f, 11, 13, 2.5f, 12, 0.5f },		// High
+	};
+
+	static void SerializeBits(FArchive& Ar, uint32& Value, int32 Bits)
+	{
+		Ar.SerializeInt(Value, 1u << Bits);
+	}
+
+	static void SerializeSigned(FArchive& Ar, double& Value, int32 Bits, float Step)
+	{
+		const int32 MaxSteps = (1 << (Bits - 1)) - 1;
+		uint32 Packed = 0;
+		if( Ar.IsSaving() )
+		{
+			Packed = FMath::Clamp(FMath::RoundToInt32(Value / Step), -MaxSteps, MaxSteps) + MaxSteps;
+		}
+		SerializeBits(Ar, Packed, Bits);
+		if( Ar.IsLoading() )
+		{
+			Value = (FMath::Min<int32>(Packed, MaxSteps * 2) - MaxSteps) * Step;
+		}
+	}
+
+	static void SerializeCell(FArchive& Ar, int32& Cell) // Zigzag so small negative cells stay small
+	{
+		uint32 Packed = Ar.IsSaving() ? ((uint32(Cell) << 1) ^ uint32(Cell >> 31)) : 0;
+		Ar.SerializeIntPacked(Packed);
+		if( Ar.IsLoading() )
+		{
+			Cell = int32(Packed >> 1) ^ -int32(Packed & 1);
+		}
+	}
+
+	static void SerializePosition(FArchive& Ar, FVector& Position, const FPrecisionInfo& Info)
+	{
+		const uint32 MaxOffset = (1u << Info.PositionBits) - 1;
+		int32 Cells[3] = { 0, 0, 0 };
+		uint32 Offsets[3] = { 0, 0, 0 };
+		if( Ar.IsSaving() )
+		{
+			for( int32 Axis = 0; Axis < 3; ++Axis )
+			{
+				Cells[Axis] = FMath::FloorToInt32((Position[Axis] + HalfCellSize) / CellSize);
+				const double Offset = Position[Axis] - Cells[Axis] * CellSize + HalfCellSize;
+				Offsets[Axis] = FMath::Min<uint32>(FMath::RoundToInt32(Offset / Info.PositionStep), MaxOffset);
+			}
+		}
+
+		uint8 HasCell = (Cells[0] | Cells[1] | Cells[2]) != 0;
+		Ar.SerializeBits(&HasCell, 1);
+		for( int32 Axis = 0; Axis < 3; ++Axis )
+		{
+			if( HasCell ) SerializeCell(Ar, Cells[Axis]);
+			SerializeBits(Ar, Offsets[Axis], Info.PositionBits);
+		}
+
+		if( Ar.IsLoading() )
+		{
+			for( int32 Axis = 0; Axis < 3; ++Axis )
+			{
+				Position[Axis] = Cells[Axis] * CellSize - HalfCellSize + Offsets[Axis] * double(Info.PositionStep);
+			}
+		}
+	}
+
+	static void SerializeRotation(FArchive& Ar, FRotator& Rotation, int32 Bits) // Smallest three, the largest component is rebuilt from the others
+	{
+		const double Range = UE_DOUBLE_INV_SQRT_2;
+		const uint32 MaxValue = (1u << Bits) - 1;
+		uint32 LargestIndex = 0;
+		uint32 Packed[3] = { 0, 0, 0 };
+		if( Ar.IsSaving() )
+		{
+			const FQuat Quat = Rotation.Quaternion().GetNormalized();
+			double Components[4] = { Quat.X, Quat.Y, Quat.Z, Quat.W };
+			for( uint32 Index = 1; Index < 4; ++Index )
+			{
+				if( FMath::Abs(Components[Index]) > FMath::Abs(Components[LargestIndex]) ) LargestIndex = Index;
+			}
+			const double Sign = Components[LargestIndex] < 0.0 ? -1.0 : 1.0; // q and -q are the same rotation, keep the largest positive
+			for( uint32 Index = 0, Out = 0; Index < 4; ++Index )
+			{
+				if( Index == LargestIndex ) continue;
+				const double Normalized = FMath::Clamp((Components[Index] * Sign / Range + 1.0) * 0.5, 0.0, 1.0);
+				Packed[Out++] = FMath::RoundToInt32(Normalized * MaxValue);
+			}
+		}
+
+		SerializeBits(Ar, LargestIndex, 2);
+		for( int32 Index = 0; Index < 3; ++Index )
+		{
+			SerializeBits(Ar, Packed[Index], Bits);
+		}
+
+		if( Ar.IsLoading() )
+		{
+			double Components[4];
+			double SumSquared = 0.0;
+			for( uint32 Index = 0, In = 0; Index < 4; ++Index )
+			{
+				if( Index == LargestIndex ) continue;
+				Components[Index] = (double(FMath::Min(Packed[In++], MaxValue)) / MaxValue * 2.0 - 1.0) * Range;
+				SumSquared += Components[Index] * Components[Index];
+			}
+			Components[LargestIndex] = FMath::Sqrt(FMath::Max(0.0, 1.0 - SumSquared));
+			Rotation = FQuat(Components[0], Components[1], Components[2], Components[3]).GetNormalized().Rotator();
+		}
+	}
+}
+
+bool FNetState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	using namespace AVS_NetState;
+
+	uint32 PrecisionValue = static_cast<uint32>(Precision);
+	SerializeBits(Ar, PrecisionValue, 2);
+	Precision = static_cast<ENetStatePrecision>(PrecisionValue);
+
+	if( Precision == ENetStatePrecision::Full )
+	{
+		FVector3f Position(position), Velocity(velocity), AngularVelocity(angularVelocity);
+		float Pitch = rotation.Pitch, Yaw = rotation.Yaw, Roll = rotation.Roll;
+		Ar << NetTimestamp << Position << Pitch << Yaw << Roll << Velocity << AngularVelocity;
+		if( Ar.IsLoading() )
+		{
+			position = FVector(Position);
+			rotation = FRotator(Pitch, Yaw, Roll);
+			velocity = FVector(Velocity);
+			angularVelocity = FVector(AngularVelocity);
+			TimestampWrapped = false;
+		}
+		bOutSuccess = !Ar.IsError();
+		return true;
+	}
+
+	const FPrecisionInfo& Info = PrecisionInfos[PrecisionValue];
+
+	uint32 Timestamp = Ar.IsSaving() ? uint32(FMath::RoundToInt64(NetTimestamp / TimestampStep) & ((1 << TimestampBits) - 1)) : 0;
+	SerializeBits(Ar, Timestamp, TimestampBits);
+
+	SerializePosition(Ar, position, Info);
+	SerializeRotation(Ar, rotation, Info.RotationBits);
+	for( int32 Axis = 0; Axis < 3; ++Axis )
+	{
+		SerializeSigned(Ar, velocity[Axis], Info.VelocityBits, Info.VelocityStep);
+	}
+	for( int32 Axis = 0; Axis < 3; ++Axis )
+	{
+		SerializeSigned(Ar, angularVelocity[Axis], Info.AngularBits, Info.AngularStep);
+	}
+
+	if( Ar.IsLoading() )
+	{
+		NetTimestamp = Timestamp * TimestampStep;
+		TimestampWrapped = true;
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+void FNetState::UnwrapTimestamp(float ReferenceTime)
+{
+	using namespace AVS_NetState;
+
+	if( !TimestampWrapped )
+		return;
+	TimestampWrapped = false;
+
+	// Pick the period that puts the timestamp closest to the receiver's clock
+	float Unwrapped = FMath::FloorToFloat(ReferenceTime / TimestampPeriod) * TimestampPeriod + NetTimestamp;
+	if( Unwrapped - ReferenceTime > TimestampPeriod * 0.5f ) Unwrapped -= TimestampPeriod;
+	else if( ReferenceTime - Unwrapped > TimestampPeriod * 0.5f ) Unwrapped += TimestampPeriod;
+	NetTimestamp = Unwrapped;
+}
+
+float FNetState::GetPositionTolerance(ENetStatePrecision InPrecision)
+{
+	if( InPrecision == ENetStatePrecision::Full )
+		return 0.0f;
+	// Half a step per axis
+	return AVS_NetState::PrecisionInfos[static_cast<int32>(InPrecision)].PositionStep * 0.5f * UE_SQRT_3;
+}
+
+bool FAVS_NetStateBuffer::Add(const FNetState& State, float LocalTime)
+{
+	// Oldest state is the one currently being played, anything before it is too late
+	if( Count > 0 && State.NetTimestamp <= Get(0).NetTimestamp )
+		return false;
+
+	// Follow the fastest packets right away and drift slowly towards slower ones, jitter is covered by the render delay
+	const float Offset = LocalTime - State.NetTimestamp;
+	if( !HasTimeOffset || Offset < TimeOffset )
+	{
+		TimeOffset = Offset;
+		HasTimeOffset = true;
+	}
+	else
+	{
+		TimeOffset += (Offset - TimeOffset) * 0.02f;
+	}
+
+	// States almost always arrive in order, only shift the few newer states if one was late
+	int32 Index = Count;
+	while( Index > 0 && Get(Index - 1).NetTimestamp >= State.NetTimestamp )
+	{
+		if( Get(Index - 1).NetTimestamp == State.NetTimestamp )
+			return false; // Duplicate
+		--Index;
+	}
+
+	if( Count == Capacity ) // Flooded, drop the oldest
+	{
+		INC_DWORD_STAT(STAT_AVS_StatesDropped);
+		Head = (Head + 1) % Capacity;
+		--Count;
+		--Index;
+	}
+	for( int32 Move = Count; Move > Index; --Move )
+	{
+		States[(Head + Move) % Capacity] = Get(Move - 1);
+	}
+
+	FNetState& NewState = States[(Head + Index) % Capacity];
+	NewState = State;
+	NewState.LocalTimestamp = LocalTime;
+	++Count;
+	return true;
+}
+
+void FAVS_NetStateBuffer::Reset()
+{
+	Head = 0;
+	Count = 0;
+	HasTimeOffset = false;
+}
+
+void FAVS_NetStateBuffer::DiscardBefore(float Time)
+{
+	while( Count >= 2 && Get(1).NetTimestamp <= Time )
+	{
+		Head = (Head + 1) % Capacity;
+		--Count;
+	}
+}
+
+bool FAVS_NetStateBuffer::Sample(float Time, float MaxExtrapolation, FNetState& OutState) const
+{
+	if( Count == 0 || Time < Get(0).NetTimestamp )
+		return false;
+
+	// First pair that contains Time
+	for( int32 Index = 0; Index + 1 < Count; ++Index )
+	{
+		const FNetState& From = Get(Index);
+		const FNetState& To = Get(Index + 1);
+		if( Time > To.NetTimestamp )
+			continue;
+
+		const float Duration = To.NetTimestamp - From.NetTimestamp;
+		const float Alpha = FMath::Clamp((Time - From.NetTimestamp) / Duration, 0.0f, 1.0f);
+		const float Alpha2 = Alpha * Alpha;
+		const float Alpha3 = Alpha2 * Alpha;
+
+		// Hermite basis, the tangents are the sent velocities scaled to the time between states
+		const float H00 = 2.0f * Alpha3 - 3.0f * Alpha2 + 1.0f;
+		const float H10 = Alpha3 - 2.0f * Alpha2 + Alpha;
+		const float H01 = -2.0f * Alpha3 + 3.0f * Alpha2;
+		const float H11 = Alpha3 - Alpha2;
+		OutState = From;
+		OutState.NetTimestamp = Time;
+		OutState.position = From.position * H00 + From.velocity * (H10 * Duration) + To.position * H01 + To.velocity * (H11 * Duration);
+		OutState.velocity = (From.position - To.position) * ((6.0f * Alpha2 - 6.0f * Alpha) / Duration)
+			+ From.velocity * (3.0f * Alpha2 - 4.0f * Alpha + 1.0f) + To.velocity * (3.0f * Alpha2 - 2.0f * Alpha);
+		OutState.rotation = FQuat::Slerp(From.rotation.Quaternion(), To.rotation.Quaternion(), Alpha).Rotator();
+		OutState.angularVelocity = FMath::Lerp(From.angularVelocity, To.angularVelocity, Alpha);
+		return true;
+	}
+
+	// Late packets, dead reckon from the newest state and hold once the limit is reached
+	const FNetState& Newest = Get(Count - 1);
+	const float ExtrapolateTime = FMath::Min(Time - Newest.NetTimestamp, MaxExtrapolation);
+	OutState = Newest;
+	OutState.NetTimestamp = Newest.NetTimestamp + ExtrapolateTime;
+	OutState.position = Newest.position + Newest.velocity * ExtrapolateTime;
+	const FVector AngularVelocity = FMath::DegreesToRadians(Newest.angularVelocity);
+	const float Angle = AngularVelocity.Size() * ExtrapolateTime;
+	if( Angle > UE_KINDA_SMALL_NUMBER )
+	{
+		OutState.rotation = (FQuat(AngularVelocity.GetUnsafeNormal(), Angle) * Newest.rotation.Quaternion()).Rotator();
+	}
+	return true;
+}
@@ -3,13 +3,36 @@
 
 #include "VehiclePhysicsCallback.h"
 
+#include "AVS_DEBUG.h"
 #include "PBDRigidsSolver.h"
 #include "VehicleSystemBase.h"
-#include "Chaos/ContactModification.h"
+#include "Chaos/PBDRigidsEvolutionGBF.h"
+#include "Async/ParallelFor.h"
+
+static TAutoConsoleVariable<int32> CVarAVSParallelVehicles(
+	TEXT("avs.ParallelVehicles"),
+	1,
+	TEXT("Simulate vehicles in parallel on the physics thread. 0: serial, 1: parallel"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarAVSParallelMinVehicles(
+	TEXT("avs.ParallelMinVehicles"),
+	4,
+	TEXT("Minimum number of simulated vehicles before the physics step is split across worker threads"),
+	ECVF_Default);
+
+#if !UE_BUILD_SHIPPING && !UE_BUILD_TEST
+static TAutoConsoleVariable<int32> CVarAVSWarnOutputGrowth(
+	TEXT("avs.WarnOutputGrowth"),
+	0,
+	TEXT("Log a warning whenever a vehicle's physics output has to grow its buffers during a step. Once warmed up this should stay silent, every warning is a heap allocation"),
+	ECVF_Default);
+#endif
 
 void FVehiclePhysicsCallback::OnPreSimulate_Internal()
 {
 	using namespace Chaos;
+	AVS_SCOPE_CYCLE_COUNTER(PhysicsStep);
 
 	float ChaosDeltaTime = GetDeltaTime_Internal();
 
@@ -17,30 +40,91 @@ void FVehiclePhysicsCallback::OnPreSimulate_Internal()
 	NewOutput.ChaosDeltaTime = ChaosDeltaTime;
 	
 	const FVehiclePhysicsPhysicsInput* Input = GetConsumerInput_Internal();
-	if (Input == nullptr || Input->VehicleMeshPrim == nullptr )
+	if (Input == nullptr)
 		return;
 	
 	Chaos::FPhysicsSolver* PhysicsSolver = static_cast<Chaos::FPhysicsSolver*>(GetSolver());
 	if (PhysicsSolver == nullptr)
 		return;
 
-	FPhysicsActorHandle ActorHandle = Input->VehicleMeshPrim->GetBodyInstance()->GetPhysicsActorHandle();
-	if(ActorHandle == nullptr)
-		return;
-	
-	Chaos::FRigidBodyHandle_Internal* PhysicsHandle = ActorHandle->GetPhysicsThreadAPI();
-	if(PhysicsHandle != nullptr)
+	// Find every vehicle that can be simulated this step and gather their wheel rays
+	SimulatedVehicles.Reset();
+	WheelQueries.Reset();
+	for( int32 VIndex = 0; VIndex < Input->Vehicles.Num(); ++VIndex )
 	{
-		Chaos::EObjectStateType PhysicsState = PhysicsHandle->ObjectState();
-		if( PhysicsState == Chaos::EObjectStateType::Dynamic )
+		AVS_SCOPE_CYCLE_COUNTER(GatherQueries);
+		const FAVS_VehiclePhysicsInput& VehicleInput = Input->Vehicles[VIndex];
+		if( VehicleInput.VehicleMeshPrim == nullptr )
+			continue;
+
+		FPhysicsActorHandle ActorHandle = VehicleInput.VehicleMeshPrim->GetBodyInstance()->GetPhysicsActorHandle();
+		if( ActorHandle == nullptr )
+			continue;
+
+		Chaos::FRigidBodyHandle_Internal* PhysicsHandle = ActorHandle->GetPhysicsThreadAPI();
+		if( PhysicsHandle == nullptr || PhysicsHandle->ObjectState() != Chaos::EObjectStateType::Dynamic )
+			continue;
+
+		AVehicleSystemBase* MyVehicle = Cast<AVehicleSystemBase>(VehicleInput.VehicleActor.Get());
+		if( MyVehicle == nullptr )
+			continue;
+
+		// Skipped until the vehicle's wheel configs have reached the physics thread
+		if( !MyVehicle->AVS_GatherWheelQueries(VehicleInput, Input->GetVehicleWheelConfigs(VehicleInput), Input->GetVehicleWheelTireTables(VehicleInput),
+			Input->GetVehicleWheels(VehicleInput), WheelQueries) )
+			continue;
+
+		const int32 OutputIndex = NewOutput.AddVehicle(VehicleInput.VehicleActor);
+		SimulatedVehicles.Add({MyVehicle, VIndex, OutputIndex});
+	}
+
+	SET_DWORD_STAT(STAT_AVS_SimulatedVehicles, SimulatedVehicles.Num());
+	SET_DWORD_STAT(STAT_AVS_TracesPerStep, WheelQueries.Rays.Num());
+
+	// One scene query pass for every wheel in the world
+	{
+		AVS_SCOPE_CYCLE_COUNTER(WheelTraces);
+		WheelQueries.Execute(Input->World.Get());
+	}
+
+	// Grow only, the accumulators keep their allocations between steps
+	if( VehicleForces.Num() < SimulatedVehicles.Num() )
+	{
+		VehicleForces.SetNum(SimulatedVehicles.Num());
+	}
+
+	// Vehicles are independent until their forces are applied, each one only reads rigid bodies and writes to its own output
+	const bool SingleThreaded = CVarAVSParallelVehicles.GetValueOnAnyThread() == 0 || SimulatedVehicles.Num() < CVarAVSParallelMinVehicles.GetValueOnAnyThread();
+	ParallelFor(SimulatedVehicles.Num(), [this, Input, &NewOutput, ChaosDeltaTime](int32 SIndex)
+	{
+		const FSimulatedVehicle& Simulated = SimulatedVehicles[SIndex];
+		const FAVS_VehiclePhysicsInput& VehicleInput = Input->Vehicles[Simulated.InputIndex];
+
+		FAVS_ForceAccumulator& Forces = VehicleForces[SIndex];
+		Forces.Reset();
+
+		FAVS_VehiclePhysicsOutput& VehicleOutput = NewOutput.Vehicles[Simulated.OutputIndex];
+		#if !UE_BUILD_SHIPPING && !UE_BUILD_TEST
+		const SIZE_T AllocatedSize = VehicleOutput.GetAllocatedSize();
+		#endif
+
+		//MyVehicle->AVS_PhysicsTickBP(ChaosDeltaTime); // Physics Thread in Blueprint
+		AVS_SCOPE_CYCLE_COUNTER(PhysicsTick);
+		Simulated.Vehicle->AVS_PhysicsTick(ChaosDeltaTime, Input->GravityZ, VehicleInput, VehicleOutput, WheelQueries, Forces);
+
+		#if !UE_BUILD_SHIPPING && !UE_BUILD_TEST
+		if( CVarAVSWarnOutputGrowth.GetValueOnAnyThread() != 0 && VehicleOutput.GetAllocatedSize() > AllocatedSize )
 		{
-			AVehicleSystemBase* MyVehicle = Cast<AVehicleSystemBase>(Input->VehicleActor);
-			if(MyVehicle != nullptr)
-			{
-				//MyVehicle->AVS_PhysicsTickBP(ChaosDeltaTime); // Physics Thread in Blueprint
-				MyVehicle->AVS_PhysicsTick(ChaosDeltaTime, Input, NewOutput);
-			}
+			UE_LOG(LogAVS, Warning, TEXT("avs.WarnOutputGrowth: %s output grew from %llu to %llu bytes"), *Simulated.Vehicle->GetName(), (uint64)AllocatedSize, (uint64)VehicleOutput.GetAllocatedSize());
 		}
+		#endif
+	}, SingleThreaded);
+
+	// Rigid bodies are not thread safe, apply every vehicle's forces from this thread
+	AVS_SCOPE_CYCLE_COUNTER(ApplyForces);
+	for( int32 SIndex = 0; SIndex < SimulatedVehicles.Num(); ++SIndex )
+	{
+		VehicleForces[SIndex].Apply();
 	}
 }
 
@@ -68,30 +152,52 @@ ForwardSpeed = FVector::DotProduct(VehicleWorldVelocity, VehicleForwardAxis);
 ForwardsAcceleration = LocalAcceleration.X;
 */
 
-void FVehiclePhysicsCallback::OnContactModification_Internal(Chaos::FCollisionContactModifier& Modifier)
+void FVehiclePhysicsCallback::SetDisabledCollisions_Internal(Chaos::FUniqueIdx VehicleIdx, Chaos::FSingleParticlePhysicsProxy* VehicleProxy,
+	const TArray<Chaos::FUniqueIdx>& WheelIndices, const TArray<Chaos::FSingleParticlePhysicsProxy*>& WheelProxies)
 {
 	using namespace Chaos;
-	
-	if(VehicleMesh == nullptr)
+
+	FPhysicsSolver* PhysicsSolver = static_cast<FPhysicsSolver*>(GetSolver());
+	if( PhysicsSolver == nullptr || !VehicleIdx.IsValid() )
 		return;
-	
-	for (Chaos::FContactPairModifier& PairModifier : Modifier)
+
+	// Pairs in here never reach narrowphase, unlike contact modification which pays for the contacts first and then throws them away
+	FIgnoreCollisionManager& IgnoreManager = PhysicsSolver->GetEvolution()->GetBroadPhase().GetIgnoreCollisionManager();
+
+	// Either particle of a pair can be the one the broadphase asks, so every pair is registered both ways.
+	// Removing only needs the indices, the vehicle or a mesh may be gone by now
+	if( const TArray<FUniqueIdx>* OldWheels = DisabledCollisions.Find(VehicleIdx) )
 	{
-		FSingleParticlePhysicsProxy* ContactObject1 = static_cast<FSingleParticlePhysicsProxy*>(PairModifier.GetParticlePair()[0]->PhysicsProxy());
-		FSingleParticlePhysicsProxy* ContactObject2 = static_cast<FSingleParticlePhysicsProxy*>(PairModifier.GetParticlePair()[1]->PhysicsProxy());
-		if(ContactObject1 == VehicleMesh)
+		for( const FUniqueIdx OldWheel : *OldWheels )
 		{
-			if(WheelMeshes.Contains(ContactObject2))
+			if( !WheelIndices.Contains(OldWheel) )
 			{
-				PairModifier.Disable(); // Disable Collision
-			}
-		}
-		else if (ContactObject2 == VehicleMesh)
-		{
-			if(WheelMeshes.Contains(ContactObject1))
-			{
-				PairModifier.Disable(); // Disable Collision
+				// Flags are left on, other systems may have registered their own pairs for these particles
+				IgnoreManager.RemoveIgnoreCollisionsFor(VehicleIdx, OldWheel);
+				IgnoreManager.RemoveIgnoreCollisionsFor(OldWheel, VehicleIdx);
 			}
 		}
 	}
-}
\ No newline at end of file
+
+	FPBDRigidParticleHandle* VehicleHandle = (VehicleProxy && VehicleProxy->GetHandle_LowLevel()) ? VehicleProxy->GetHandle_LowLevel()->CastToRigidParticle() : nullptr;
+	if( WheelIndices.Num() == 0 || VehicleHandle == nullptr )
+	{
+		DisabledCollisions.Remove(VehicleIdx);
+		return;
+	}
+
+	TArray<FUniqueIdx>& Registered = DisabledCollisions.FindOrAdd(VehicleIdx);
+	Registered.Reset();
+	for( int32 Index = 0; Index < WheelIndices.Num(); ++Index )
+	{
+		FPBDRigidParticleHandle* WheelHandle = WheelProxies[Index]->GetHandle_LowLevel() ? WheelProxies[Index]->GetHandle_LowLevel()->CastToRigidParticle() : nullptr;
+		if( WheelHandle == nullptr )
+			continue;
+
+		VehicleHandle->AddCollisionConstraintFlag(ECollisionConstraintFlags::CCF_BroadPhaseIgnoreCollisions);
+		WheelHandle->AddCollisionConstraintFlag(ECollisionConstraintFlags::CCF_BroadPhaseIgnoreCollisions);
+		IgnoreManager.AddIgnoreCollisionsFor(VehicleIdx, WheelIndices[Index]);
+		IgnoreManager.AddIgnoreCollisionsFor(WheelIndices[Index], VehicleIdx);
+		Registered.Add(WheelIndices[Index]);
+	}
+}
@@ -0,0 +1,135 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehiclePhysicsSubsystem.h"
+
+#include "AVS_DEBUG.h"
+#include "PBDRigidsSolver.h"
+#include "VehicleSystemBase.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+
+void UVehiclePhysicsSubsystem::Deinitialize()
+{
+	// Freed by the solver after the commands already queued with it, those may still point at the callback
+	DestroyPhysicsCallback();
+	RegisteredVehicles.Empty();
+	Super::Deinitialize();
+}
+
+void UVehiclePhysicsSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Normally already done by the first vehicle that ticked, sleeping vehicles do not so the outputs would pile up
+	UpdatePhysicsOutputs_External();
+
+	#if STATS
+	int32 NumPassive = 0;
+	for( const AVehicleSystemBase* Vehicle : RegisteredVehicles )
+	{
+		NumPassive += (IsValid(Vehicle) && Vehicle->PassiveMode) ? 1 : 0;
+	}
+	SET_DWORD_STAT(STAT_AVS_ActiveVehicles, RegisteredVehicles.Num() - NumPassive);
+	SET_DWORD_STAT(STAT_AVS_PassiveVehicles, NumPassive);
+	#endif
+}
+
+bool UVehiclePhysicsSubsystem::CreatePhysicsCallback()
+{
+	if( PhysicsCallback != nullptr )
+		return true;
+
+	if( FPhysScene* PhysScene = GetWorld()->GetPhysicsScene() )
+	{
+		PhysicsCallback = PhysScene->GetSolver()->CreateAndRegisterSimCallbackObject_External<FVehiclePhysicsCallback>(); // Unreal 5.1+
+	}
+	return PhysicsCallback != nullptr;
+}
+
+void UVehiclePhysicsSubsystem::DestroyPhysicsCallback()
+{
+	if( PhysicsCallback == nullptr )
+		return;
+
+	if( FPhysScene* PhysScene = GetWorld()->GetPhysicsScene() )
+	{
+		PhysScene->GetSolver()->UnregisterAndFreeSimCallbackObject_External(PhysicsCallback);
+	}
+	PhysicsCallback = nullptr;
+}
+
+bool UVehiclePhysicsSubsystem::RegisterVehicle(AVehicleSystemBase* Vehicle)
+{
+	if( !IsValid(Vehicle) || !CreatePhysicsCallback() )
+		return false;
+
+	RegisteredVehicles.AddUnique(Vehicle);
+	return true;
+}
+
+void UVehiclePhysicsSubsystem::UnregisterVehicle(AVehicleSystemBase* Vehicle)
+{
+	// The callback is kept until Deinitialize even without vehicles, queued physics thread commands still use it
+	RegisteredVehicles.Remove(Vehicle);
+}
+
+FVehiclePhysicsPhysicsInput* UVehiclePhysicsSubsystem::GetProducerInput_External()
+{
+	if( PhysicsCallback == nullptr )
+		return nullptr;
+
+	FVehiclePhysicsPhysicsInput* PhysicsInput = PhysicsCallback->GetProducerInputData_External();
+	PhysicsInput->World = GetWorld();
+	PhysicsInput->GravityZ = GetWorld()->GetGravityZ();
+	return PhysicsInput;
+}
+
+void UVehiclePhysicsSubsystem::UpdatePhysicsOutputs_External()
+{
+	if( PhysicsCallback == nullptr || LastOutputFrame == GFrameCounter )
+		return;
+	LastOutputFrame = GFrameCounter;
+	AVS_SCOPE_CYCLE_COUNTER(MarshalOut);
+
+	// There can be multiple outputs made between frames, only the newest output of each vehicle is used
+	PendingOutputs.Reset();
+	while( Chaos::TSimCallbackOutputHandle<FVehiclePhysicsPhysicsOutput> PhysicsOutput = PhysicsCallback->PopOutputData_External() )
+	{
+		PendingOutputs.Add(MoveTemp(PhysicsOutput));
+	}
+
+	FAVS_LatestPhysicsOutput::HandOut(MakeArrayView(PendingOutputs), LastOutputFrame, [](const FAVS_VehiclePhysicsOutput& VehicleOutput)
+	{
+		AVehicleSystemBase* Vehicle = Cast<AVehicleSystemBase>(VehicleOutput.VehicleActor.Get());
+		return Vehicle ? &Vehicle->LatestPhysicsOutput : nullptr;
+	});
+
+	// Handing the outputs back to the callback's pool, they keep the buffers swapped in from the vehicles
+	PendingOutputs.Reset();
+}
+
+void UVehiclePhysicsSubsystem::SetDisabledCollisions(Chaos::FSingleParticlePhysicsProxy* VehicleProxy, const TArray<Chaos::FSingleParticlePhysicsProxy*>& WheelProxies)
+{
+	if( PhysicsCallback == nullptr || VehicleProxy == nullptr )
+		return;
+
+	FPhysScene* PhysScene = GetWorld()->GetPhysicsScene();
+	if( PhysScene == nullptr )
+		return;
+
+	// Unique indices outlive the proxies on the physics thread, the pairs can still be removed once a mesh is destroyed
+	const Chaos::FUniqueIdx VehicleIdx = VehicleProxy->GetGameThreadAPI().UniqueIdx();
+	TArray<Chaos::FUniqueIdx> WheelIndices;
+	WheelIndices.Reserve(WheelProxies.Num());
+	for( Chaos::FSingleParticlePhysicsProxy* WheelProxy : WheelProxies )
+	{
+		WheelIndices.Add(WheelProxy->GetGameThreadAPI().UniqueIdx());
+	}
+
+	// Particle handles and the ignore collision manager belong to the physics thread, queue the change instead of writing it from here
+	FVehiclePhysicsCallback* Callback = PhysicsCallback;
+	PhysScene->GetSolver()->EnqueueCommandImmediate([Callback, VehicleIdx, VehicleProxy, WheelIndices = MoveTemp(WheelIndices), WheelProxies]()
+	{
+		Callback->SetDisabledCollisions_Internal(VehicleIdx, VehicleProxy, WheelIndices, WheelProxies);
+	});
+}
@@ -0,0 +1,102 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehicleRestManager.h"
+
+#include "EngineUtils.h"
+#include "Net/UnrealNetwork.h"
+
+void FAVS_RestEntry::PreReplicatedRemove(const FAVS_RestArray& InArraySerializer)
+{
+	if( IsValid(Vehicle) )
+	{
+		Vehicle->ReceiveManagedRestState(FNetState()); // Blank state, no longer at rest
+	}
+}
+
+void FAVS_RestEntry::PostReplicatedAdd(const FAVS_RestArray& InArraySerializer)
+{
+	if( IsValid(Vehicle) ) // Null until the vehicle itself has replicated, it asks for its entry in BeginPlay
+	{
+		Vehicle->ReceiveManagedRestState(State);
+	}
+}
+
+void FAVS_RestEntry::PostReplicatedChange(const FAVS_RestArray& InArraySerializer)
+{
+	if( IsValid(Vehicle) )
+	{
+		Vehicle->ReceiveManagedRestState(State);
+	}
+}
+
+AVehicleRestManager::AVehicleRestManager()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	NetUpdateFrequency = 10.0f; // Rest states change rarely, only changed entries are sent
+}
+
+void AVehicleRestManager::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(AVehicleRestManager, RestVehicles);
+}
+
+AVehicleRestManager* AVehicleRestManager::Get(UWorld* World, bool Create)
+{
+	if( World == nullptr )
+		return nullptr;
+
+	for( TActorIterator<AVehicleRestManager> It(World); It; ++It )
+	{
+		return *It;
+	}
+
+	if( Create && World->GetNetMode() != NM_Client )
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		return World->SpawnActor<AVehicleRestManager>(SpawnParams);
+	}
+	return nullptr;
+}
+
+void AVehicleRestManager::SetRestState(AVehicleSystemBase* Vehicle, const FNetState& State)
+{
+	if( State.position == FVector::ZeroVector )
+	{
+		RemoveVehicle(Vehicle);
+		return;
+	}
+
+	FAVS_RestEntry* Entry = RestVehicles.Items.FindByPredicate([Vehicle](const FAVS_RestEntry& Item) { return Item.Vehicle == Vehicle; });
+	if( Entry == nullptr )
+	{
+		Entry = &RestVehicles.Items.AddDefaulted_GetRef();
+		Entry->Vehicle = Vehicle;
+	}
+	Entry->State = State;
+	RestVehicles.MarkItemDirty(*Entry);
+}
+
+void AVehicleRestManager::RemoveVehicle(const AVehicleSystemBase* Vehicle)
+{
+	const int32 Index = RestVehicles.Items.IndexOfByPredicate([Vehicle](const FAVS_RestEntry& Item) { return Item.Vehicle == Vehicle; });
+	if( Index != INDEX_NONE )
+	{
+		RestVehicles.Items.RemoveAtSwap(Index);
+		RestVehicles.MarkArrayDirty();
+	}
+}
+
+bool AVehicleRestManager::FindRestState(const AVehicleSystemBase* Vehicle, FNetState& OutState) const
+{
+	const FAVS_RestEntry* Entry = RestVehicles.Items.FindByPredicate([Vehicle](const FAVS_RestEntry& Item) { return Item.Vehicle == Vehicle; });
+	if( Entry == nullptr )
+		return false;
+
+	OutState = Entry->State;
+	return true;
+}
@@ -0,0 +1,286 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehicleSurfaceGrid.h"
+
+#include "AVS_DEBUG.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Components/PrimitiveComponent.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+bool FAVS_SurfaceGridData::GetSample(int32 X, int32 Y, float& OutHeight, FVector& OutNormal, uint8& OutMaterial) const
+{
+	if( X < 0 || Y < 0 || X >= NumSamples.X || Y >= NumSamples.Y )
+		return false;
+
+	const int32* TileIndex = TileLookup.Find(FIntPoint(X / TileSize, Y / TileSize));
+	if( TileIndex == nullptr )
+		return false;
+
+	const FAVS_SurfaceTile& Tile = Tiles[*TileIndex];
+	const int32 Index = (Y % TileSize) * TileSize + (X % TileSize);
+	OutMaterial = Tile.Materials[Index];
+	if( OutMaterial == InvalidSample )
+		return false;
+
+	OutHeight = Tile.Heights[Index];
+	const FVector2f NormalXY = Tile.Normals[Index];
+	OutNormal = FVector(NormalXY.X, NormalXY.Y, FMath::Sqrt(FMath::Max(0.0f, 1.0f - NormalXY.SizeSquared())));
+	return true;
+}
+
+bool FAVS_SurfaceGridData::Trace(const FVector& Start, const FVector& End, FAVS_WheelHit& OutHit) const
+{
+	// Surface is looked up under the middle of the ray, wheel rays are short so it barely moves along them
+	const FVector Middle = (Start + End) * 0.5f;
+	const double GridX = (Middle.X - Origin.X) / CellSize;
+	const double GridY = (Middle.Y - Origin.Y) / CellSize;
+	if( GridX < 0.0 || GridY < 0.0 )
+		return false;
+
+	const int32 X0 = static_cast<int32>(GridX);
+	const int32 Y0 = static_cast<int32>(GridY);
+	const float AlphaX = static_cast<float>(GridX - X0);
+	const float AlphaY = static_cast<float>(GridY - Y0);
+
+	// Every corner of the cell has to be drivable, invalid samples mark edges and anything that was not static
+	float Heights[4];
+	FVector Normals[4];
+	uint8 CornerMaterials[4];
+	for( int32 Corner = 0; Corner < 4; ++Corner )
+	{
+		if( !GetSample(X0 + (Corner & 1), Y0 + (Corner >> 1), Heights[Corner], Normals[Corner], CornerMaterials[Corner]) )
+			return false;
+	}
+
+	const float Height = FMath::Lerp(FMath::Lerp(Heights[0], Heights[1], AlphaX), FMath::Lerp(Heights[2], Heights[3], AlphaX), AlphaY);
+	const FVector Normal = FMath::Lerp(FMath::Lerp(Normals[0], Normals[1], AlphaX), FMath::Lerp(Normals[2], Normals[3], AlphaX), AlphaY).GetSafeNormal();
+	const int32 NearestCorner = (AlphaX >= 0.5f ? 1 : 0) + (AlphaY >= 0.5f ? 2 : 0);
+
+	const FVector Ray = End - Start;
+	const double Denominator = FVector::DotProduct(Ray, Normal);
+	if( Denominator > -UE_KINDA_SMALL_NUMBER )
+		return false; // Wheel on its side, leave it to the scene query
+
+	const FVector SurfacePoint(Middle.X, Middle.Y, Height);
+	const double Time = FVector::DotProduct(SurfacePoint - Start, Normal) / Denominator;
+	if( Time < 0.0 )
+		return false; // Surface above the ray, the wheel is under an overhang the grid does not know about
+
+	OutHit = FAVS_WheelHit();
+	if( Time > 1.0 )
+		return true; // In the air
+
+	OutHit.bBlockingHit = true;
+	OutHit.ImpactPoint = Start + Ray * Time;
+	OutHit.Location = OutHit.ImpactPoint;
+	OutHit.ImpactNormal = Normal;
+	OutHit.Distance = Ray.Size() * Time;
+	OutHit.PhysMaterial = Materials.IsValidIndex(CornerMaterials[NearestCorner]) ? Materials[CornerMaterials[NearestCorner]] : nullptr;
+	OutHit.bStaticComponent = true;
+	return true;
+}
+
+void FAVS_SurfaceGridData::BuildLookup()
+{
+	TileLookup.Reset();
+	for( int32 TileIndex = 0; TileIndex < Tiles.Num(); ++TileIndex )
+	{
+		TileLookup.Add(Tiles[TileIndex].Coord, TileIndex);
+	}
+}
+
+void UVehicleSurfaceGrid::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	// Samples are stored raw, they are far too many to go through reflected properties
+	bool HasGridData = GridData.IsValid();
+	Ar << HasGridData;
+	if( !HasGridData )
+		return;
+
+	if( Ar.IsLoading() )
+	{
+		GridData = MakeShared<FAVS_SurfaceGridData, ESPMode::ThreadSafe>();
+	}
+	Ar << GridData->Origin << GridData->CellSize << GridData->NumSamples << GridData->Tiles;
+}
+
+void UVehicleSurfaceGrid::PostLoad()
+{
+	Super::PostLoad();
+	if( GridData.IsValid() )
+	{
+		GridData->BuildLookup();
+		GridData->Materials.Reset();
+		for( UPhysicalMaterial* Material : SurfaceMaterials )
+		{
+			GridData->Materials.Add(Material);
+		}
+	}
+}
+
+#if WITH_EDITOR
+void UVehicleSurfaceGrid::BakeEditorWorld()
+{
+	for( const FWorldContext& Context : GEngine->GetWorldContexts() )
+	{
+		if( Context.WorldType == EWorldType::Editor && Context.World() )
+		{
+			Bake(Context.World());
+			return;
+		}
+	}
+	UE_LOG(LogAVS, Warning, TEXT("%s: no editor world to bake"), *GetName());
+}
+#endif
+
+void UVehicleSurfaceGrid::Bake(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if( World == nullptr || !BakeBounds.IsValid )
+		return;
+
+	// Counted in doubles first, large bounds over a small cell size overflow int32
+	const float BakeCellSize = FMath::Max(CellSize, 5.0f);
+	const double SamplesX = FMath::CeilToDouble((BakeBounds.Max.X - BakeBounds.Min.X) / BakeCellSize) + 1.0;
+	const double SamplesY = FMath::CeilToDouble((BakeBounds.Max.Y - BakeBounds.Min.Y) / BakeCellSize) + 1.0;
+	if( SamplesX * SamplesY > FMath::Max(MaxBakeSamples, 1) )
+	{
+		UE_LOG(LogAVS, Error, TEXT("%s: %.0fx%.0f samples is over MaxBakeSamples (%d), raise CellSize or bake smaller bounds"),
+			*GetName(), SamplesX, SamplesY, MaxBakeSamples);
+		return;
+	}
+
+	TSharedPtr<FAVS_SurfaceGridData, ESPMode::ThreadSafe> NewData = MakeShared<FAVS_SurfaceGridData, ESPMode::ThreadSafe>();
+	NewData->Origin = FVector2D(BakeBounds.Min);
+	NewData->CellSize = BakeCellSize;
+	NewData->NumSamples.X = static_cast<int32>(SamplesX);
+	NewData->NumSamples.Y = static_cast<int32>(SamplesY);
+
+	// Materials are resolved to their slot while sampling, InvalidSample marks samples wheels have to trace
+	const int32 NumX = NewData->NumSamples.X;
+	const int32 NumY = NewData->NumSamples.Y;
+	TArray<float> Heights;
+	TArray<FVector3f> Normals;
+	TArray<uint8> Materials;
+	Heights.SetNumZeroed(NumX * NumY);
+	Normals.Init(FVector3f::UpVector, NumX * NumY);
+	Materials.Init(FAVS_SurfaceGridData::InvalidSample, NumX * NumY);
+	SurfaceMaterials.Reset();
+
+	// ** Sample ** //
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(AVS_SurfaceGridBake), true);
+	Params.bReturnPhysicalMaterial = true;
+	const float MinNormalZ = FMath::Cos(FMath::DegreesToRadians(MaxSlopeAngle));
+	for( int32 Y = 0; Y < NumY; ++Y )
+	{
+		for( int32 X = 0; X < NumX; ++X )
+		{
+			const FVector2D SampleXY = NewData->Origin + FVector2D(X, Y) * NewData->CellSize;
+			FHitResult Hit;
+			if( !World->LineTraceSingleByChannel(Hit, FVector(SampleXY, BakeBounds.Max.Z), FVector(SampleXY, BakeBounds.Min.Z), TraceChannel, Params) )
+				continue;
+
+			// Anything that can move has to be traced at runtime
+			if( !Hit.Component.IsValid() || Hit.Component->Mobility != EComponentMobility::Static || Hit.ImpactNormal.Z < MinNormalZ )
+				continue;
+
+			int32 MaterialIndex = SurfaceMaterials.Find(Hit.PhysMaterial.Get());
+			if( MaterialIndex == INDEX_NONE )
+			{
+				if( SurfaceMaterials.Num() >= FAVS_SurfaceGridData::InvalidSample )
+					continue; // Out of material slots, traced at runtime
+				MaterialIndex = SurfaceMaterials.Add(Hit.PhysMaterial.Get());
+			}
+
+			const int32 Index = Y * NumX + X;
+			Heights[Index] = Hit.ImpactPoint.Z;
+			Normals[Index] = FVector3f(Hit.ImpactNormal);
+			Materials[Index] = static_cast<uint8>(MaterialIndex);
+		}
+	}
+
+	// ** Discontinuities ** //
+
+	// Neighbours are compared with the average slope of both samples, steps and curbs do not follow it
+	TBitArray<> Discontinuous(false, NumX * NumY);
+	auto CheckPair = [&](int32 IndexA, int32 IndexB, bool AlongX)
+	{
+		if( Materials[IndexA] == FAVS_SurfaceGridData::InvalidSample || Materials[IndexB] == FAVS_SurfaceGridData::InvalidSample )
+			return;
+
+		const FVector3f& NormalA = Normals[IndexA];
+		const FVector3f& NormalB = Normals[IndexB];
+		const float SlopeA = AlongX ? -NormalA.X / NormalA.Z : -NormalA.Y / NormalA.Z;
+		const float SlopeB = AlongX ? -NormalB.X / NormalB.Z : -NormalB.Y / NormalB.Z;
+		const float Predicted = Heights[IndexA] + (SlopeA + SlopeB) * 0.5f * NewData->CellSize;
+		if( FMath::Abs(Heights[IndexB] - Predicted) > DiscontinuityTolerance )
+		{
+			Discontinuous[IndexA] = true;
+			Discontinuous[IndexB] = true;
+		}
+	};
+	for( int32 Y = 0; Y < NumY; ++Y )
+	{
+		for( int32 X = 0; X < NumX; ++X )
+		{
+			const int32 Index = Y * NumX + X;
+			if( X + 1 < NumX ) CheckPair(Index, Index + 1, true);
+			if( Y + 1 < NumY ) CheckPair(Index, Index + NumX, false);
+		}
+	}
+
+	// ** Tiles ** //
+
+	const int32 TileSize = FAVS_SurfaceGridData::TileSize;
+	for( int32 TileY = 0; TileY * TileSize < NumY; ++TileY )
+	{
+		for( int32 TileX = 0; TileX * TileSize < NumX; ++TileX )
+		{
+			FAVS_SurfaceTile Tile;
+			Tile.Coord = FIntPoint(TileX, TileY);
+			Tile.Heights.SetNumZeroed(TileSize * TileSize);
+			Tile.Normals.SetNumZeroed(TileSize * TileSize);
+			Tile.Materials.Init(FAVS_SurfaceGridData::InvalidSample, TileSize * TileSize);
+
+			bool HasValidSample = false;
+			for( int32 LocalY = 0; LocalY < TileSize; ++LocalY )
+			{
+				const int32 Y = TileY * TileSize + LocalY;
+				for( int32 LocalX = 0; LocalX < TileSize && Y < NumY; ++LocalX )
+				{
+					const int32 X = TileX * TileSize + LocalX;
+					const int32 Index = Y * NumX + X;
+					if( X >= NumX || Materials[Index] == FAVS_SurfaceGridData::InvalidSample || Discontinuous[Index] )
+						continue;
+
+					const int32 TileIndex = LocalY * TileSize + LocalX;
+					Tile.Heights[TileIndex] = Heights[Index];
+					Tile.Normals[TileIndex] = FVector2f(Normals[Index].X, Normals[Index].Y);
+					Tile.Materials[TileIndex] = Materials[Index];
+					HasValidSample = true;
+				}
+			}
+
+			if( HasValidSample )
+			{
+				NewData->Tiles.Add(MoveTemp(Tile));
+			}
+		}
+	}
+
+	NewData->BuildLookup();
+	for( UPhysicalMaterial* Material : SurfaceMaterials )
+	{
+		NewData->Materials.Add(Material);
+	}
+
+	GridData = NewData; // Vehicles pick it up on their next tick
+	MarkPackageDirty();
+
+	UE_LOG(LogAVS, Log, TEXT("%s: baked %dx%d samples into %d tiles"), *GetName(), NumX, NumY, NewData->Tiles.Num());
+}
@@ -8,9 +8,12 @@
 #include "AVS_DEBUG.h"
 #include "PBDRigidsSolver.h"
 #include "TimerManager.h"
+#include "VehicleNetRelay.h"
+#include "VehicleRestManager.h"
+#include "VehicleSurfaceGrid.h"
+#include "VehiclePhysicsSubsystem.h"
 #include "VehicleSystemFunctions.h"
 #include "Kismet/KismetMathLibrary.h"
-#include "Kismet/KismetSystemLibrary.h"
 #include "Net/UnrealNetwork.h"
 #include "PhysicalMaterials/PhysicalMaterial.h"
 #include "Physics/Experimental/PhysScene_Chaos.h"
@@ -30,8 +33,25 @@ AVehicleSystemBase::AVehicleSystemBase()
 	NetSendRate = 0.05f;
 	NetTimeBehind = 0.15f;
 	NetLerpStart = 0.35f;
+	NetMaxExtrapolation = 0.25f;
+	ServerAuthoritative = false;
+	NetPredictionHistory = 64;
+	NetCorrectionThreshold = 10.0f;
+	NetCorrectionBudget = 25.0f;
+	NetMaxInputTorque = 0.0f;
 	NetPositionTolerance = 0.1f;
 	NetSmoothing = 10.0f;
+	NetStatePrecision = ENetStatePrecision::Medium;
+	UseNetSendLOD = true;
+	UseRestManager = true;
+	NetSendLODOutOfViewScale = 2.0f;
+
+	// Init send rate LOD curve, full rate up close and a state every half second when far away
+	FRichCurve* NetSendLODCurveData = NetSendLODCurve.GetRichCurve();
+	NetSendLODCurveData->AddKey(0.f, 1.f);
+	NetSendLODCurveData->AddKey(50.f, 1.f);
+	NetSendLODCurveData->AddKey(150.f, 3.f);
+	NetSendLODCurveData->AddKey(400.f, 10.f);
 
 	// Init steering speed curve
 	FRichCurve* SteeringCurveData = SteeringFalloffCurve.GetRichCurve();
@@ -45,7 +65,16 @@ AVehicleSystemBase::AVehicleSystemBase()
 void AVehicleSystemBase::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	DOREPLIFETIME(AVehicleSystemBase, RestState);
+
+	FDoRepLifetimeParams RestStateParams;
+	RestStateParams.Condition = COND_Custom; // Replicated by AVehicleRestManager instead when UseRestManager is on
+	DOREPLIFETIME_WITH_PARAMS_FAST(AVehicleSystemBase, RestState, RestStateParams);
+}
+
+void AVehicleSystemBase::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+	DOREPLIFETIME_ACTIVE_OVERRIDE_FAST(AVehicleSystemBase, RestState, !UseRestManager);
 }
 
 void AVehicleSystemBase::BeginPlay()
@@ -55,20 +84,32 @@ void AVehicleSystemBase::BeginPlay()
 	RegisterPhysicsCallback();
 
 	UpdateInternalWheelArray();
+	UpdateDrivetrain();
+
+	// Wake events of sleeping passive vehicles
+	VehicleMesh->BodyInstance.bGenerateWakeEvents = true;
+	VehicleMesh->OnComponentWake.AddDynamic(this, &AVehicleSystemBase::OnVehicleMeshWake);
+	VehicleMesh->OnComponentHit.AddDynamic(this, &AVehicleSystemBase::OnVehicleMeshHit);
+
+	// The manager's entry for this vehicle can arrive before the vehicle does
+	FNetState ManagedRestState;
+	AVehicleRestManager* RestManager = (UseRestManager && !HasAuthority()) ? AVehicleRestManager::Get(GetWorld()) : nullptr;
+	if( RestManager && RestManager->FindRestState(this, ManagedRestState) )
+	{
+		ReceiveManagedRestState(ManagedRestState);
+	}
 }
 
 void AVehicleSystemBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
-	if(IsPhysicsCallbackRegistered())
+	UnregisterPhysicsCallback();
+
+	if( HasAuthority() && UseRestManager )
 	{
-		if (UWorld* World = GetWorld())
+		if( AVehicleRestManager* RestManager = AVehicleRestManager::Get(GetWorld()) )
 		{
-			if (FPhysScene* PhysScene = World->GetPhysicsScene())
-			{
-				PhysScene->GetSolver()->UnregisterAndFreeSimCallbackObject_External(PhysicsThreadCallback);
-				PhysicsThreadCallback = nullptr;
-			}
+			RestManager->RemoveVehicle(this);
 		}
 	}
 }
@@ -76,8 +117,10 @@ void AVehicleSystemBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
 void AVehicleSystemBase::PossessedBy(AController* NewController)
 {
 	Super::PossessedBy(NewController);
+	WakeFromPassive();
 	if(GetLocalRole() == ROLE_Authority)
 	{
+		SetNetDormancy(DORM_Awake); // Multicasts are not sent to dormant actors, resting dormancy is checked again on the next rest update
 		Multicast_ChangedOwner();
 	}
 	ClearQueue();
@@ -88,6 +131,7 @@ void AVehicleSystemBase::UnPossessed()
 	Super::UnPossessed();
 	if(GetLocalRole() == ROLE_Authority)
 	{
+		SetNetDormancy(DORM_Awake);
 		Multicast_ChangedOwner();
 	}
 	ClearQueue();
@@ -101,6 +145,60 @@ void AVehicleSystemBase::PassiveStateChanged_Implementation(bool NewPassiveState
 	}
 }
 
+void AVehicleSystemBase::WakeFromPassive()
+{
+	PassiveWakeTimer = PassiveWakeDuration;
+	SetPassiveSleeping(false);
+	if( PassiveMode )
+	{
+		PassiveMode = false;
+		PassiveStateChanged(false);
+	}
+}
+
+void AVehicleSystemBase::SetPassiveSleeping(bool NewSleeping)
+{
+	if( NewSleeping == PassiveSleeping ) return;
+	PassiveSleeping = NewSleeping;
+
+	if( NewSleeping )
+	{
+		// Last rest state goes out before the send timer is paused
+		if( IsSimulationAuthority() && ReplicateMovement && ShouldSyncWithServer ) NetStateSend();
+		GetWorldTimerManager().PauseTimer(NetSendTimer);
+
+		// Hits are needed to wake up from a push that does not wake the body first
+		SleepRestoreNotifyCollision = VehicleMesh->BodyInstance.bNotifyRigidBodyCollision;
+		VehicleMesh->SetNotifyRigidBodyCollision(true);
+		SetActorTickEnabled(false);
+
+		// Blueprint passive conditions (distance, cameras) can change without any event reaching the vehicle
+		GetWorldTimerManager().SetTimer(PassiveSleepCheckTimer, this, &AVehicleSystemBase::PassiveSleepCheck, FMath::Max(PassiveSleepCheckInterval, 0.1f), true);
+	}
+	else
+	{
+		GetWorldTimerManager().ClearTimer(PassiveSleepCheckTimer);
+		GetWorldTimerManager().UnPauseTimer(NetSendTimer);
+		VehicleMesh->SetNotifyRigidBodyCollision(SleepRestoreNotifyCollision);
+		SetActorTickEnabled(true);
+	}
+}
+
+void AVehicleSystemBase::PassiveSleepCheck()
+{
+	if( PassiveSleeping && !DeterminePassiveState() ) WakeFromPassive();
+}
+
+void AVehicleSystemBase::OnVehicleMeshWake(UPrimitiveComponent* WakingComponent, FName BoneName)
+{
+	if( PassiveSleeping ) WakeFromPassive();
+}
+
+void AVehicleSystemBase::OnVehicleMeshHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
+{
+	if( PassiveSleeping ) WakeFromPassive();
+}
+
 // Sets IsVehicleAtRest to true if the vehicle is within the velocity threshold for 3 seconds
 void AVehicleSystemBase::DetermineLocalRestState()
 {
@@ -136,13 +234,17 @@ void AVehicleSystemBase::TickActor(float DeltaTime, ELevelTick TickType, FActorT
 
 		// AVS performance checks
 		DetermineLocalRestState();
-		bool NewPassive = DeterminePassiveState();
+		PassiveWakeTimer = FMath::Max(PassiveWakeTimer - DeltaTime, 0.0f);
+		bool NewPassive = (PassiveWakeTimer <= 0.0f) && DeterminePassiveState();
 		if(NewPassive != PassiveMode)
 		{
 			PassiveMode = NewPassive;
 			PassiveStateChanged(NewPassive);
 		}
 		AlwaysTick();
+		UpdateWheelVisuals(DeltaTime);
+		// Only parked vehicles sleep, a moving passive vehicle still needs its suspension forces
+		if( PassiveMode && PassiveSleep && LocalVehicleAtRest && !VehicleMesh->IsAnyRigidBodyAwake() ){ SetPassiveSleeping(true); return; } // Nothing ticks until a wake event
 		if( PassiveMode && PassiveTickGatekeeping ){ PassiveTick(DeltaTime); return; } // Disallow standard tick when in passive mode
 		Super::TickActor(DeltaTime, TickType, ThisTickFunction); // Super will call standard Tick function
 	}
@@ -150,6 +252,7 @@ void AVehicleSystemBase::TickActor(float DeltaTime, ELevelTick TickType, FActorT
 
 void AVehicleSystemBase::AlwaysTick()
 {
+	AVS_SCOPE_CYCLE_COUNTER(AlwaysTick);
 	NetworkTick();
 
 	// Physics Thread
@@ -158,41 +261,31 @@ void AVehicleSystemBase::AlwaysTick()
 		// Physics thread updates
 		if( !IsPhysicsCallbackRegistered() ) return;
 
-		// Physics Thread Inputs
-		FVehiclePhysicsPhysicsInput* PhysicsInput = PhysicsThreadCallback->GetProducerInputData_External();
-		PhysicsInput->World = GetWorld();
-		PhysicsInput->VehicleActor = this;
-		PhysicsInput->VehicleMeshPrim = VehicleMesh;
-		PhysicsInput->VehicleMass = VehicleMesh->GetMass();
-		PhysicsInput->VehicleInputs = InputsForPhysicsThread;
+		// Physics Thread Inputs: Added to the world's shared input, one entry per vehicle
+		FVehiclePhysicsPhysicsInput* PhysicsInput = PhysicsSubsystem->GetProducerInput_External();
+		if( PhysicsInput == nullptr ) return;
 
-		PhysicsInput->Wheels.Reset();
-		PhysicsInput->Wheels.Reserve(VehicleWheels.Num());
+		UpdateSimulatedWheels();
+		UpdateSimulationTier();
+		MarshalPhysicsInput(*PhysicsInput);
 
-		TArray<UVehicleWheelBase*> SimulatedWheels;
-		for( UVehicleWheelBase* Wheel : VehicleWheels )
-		{
-			if( !IsValid(Wheel) ) continue;
-			
-			if( Wheel->GetIsAttached() && Wheel->GetIsSimulatingSuspension() )
-			{
-				PhysicsInput->Wheels.Add(Wheel->WheelConfig);
-				SimulatedWheels.Add(Wheel);
-			}
-		}
+		// Physics Thread Outputs: The subsystem pops the outputs for every vehicle once per frame
+		PhysicsSubsystem->UpdatePhysicsOutputs_External();
+		if( !LatestPhysicsOutput.HasNew ) return;
+		LatestPhysicsOutput.HasNew = false;
 
-		TArray<FString> DebugTexts;
-		TArray<FAVS1_Wheel_Output> WheelOutputs;
-		// Physics Thread Outputs: Done in a while loop because there can be multiple outputs made between frames
-		Chaos::TSimCallbackOutputHandle<FVehiclePhysicsPhysicsOutput> PhysicsOutput;
-		while( (PhysicsOutput = PhysicsThreadCallback->PopOutputData_External()) )
+		ChaosDeltaTime = LatestPhysicsOutput.ChaosDeltaTime;
+		AppliedWheelConfigVersion = LatestPhysicsOutput.WheelConfigVersion;
+		if( NativeDrivetrain )
 		{
-			ChaosDeltaTime = PhysicsOutput->ChaosDeltaTime;
-			DebugTraces = PhysicsOutput->DebugTraces;
-			DebugForces = PhysicsOutput->DebugForces;
-			WheelOutputs = PhysicsOutput->WheelOutputs;
-			DebugTexts = PhysicsOutput->DebugTexts;
+			CurrentGear = LatestPhysicsOutput.Gear;
+			EngineRPM = LatestPhysicsOutput.EngineRPM;
 		}
+		// Swapped rather than copied, LatestPhysicsOutput is only read once per output
+		Swap(DebugTraces, LatestPhysicsOutput.DebugTraces);
+		Swap(DebugForces, LatestPhysicsOutput.DebugForces);
+		const TArray<FString>& DebugTexts = LatestPhysicsOutput.DebugTexts;
+		const TArray<FAVS1_Wheel_Output>& WheelOutputs = LatestPhysicsOutput.WheelOutputs;
 
 		// Prints all saved debug texts
 		for( int32 i = 0; i < DebugTexts.Num(); i++ )
@@ -214,6 +307,202 @@ void AVehicleSystemBase::AlwaysTick()
 	}
 }
 
+void AVehicleSystemBase::MarshalPhysicsInput(FVehiclePhysicsPhysicsInput& PhysicsInput)
+{
+	AVS_SCOPE_CYCLE_COUNTER(MarshalIn);
+
+	FAVS_VehiclePhysicsInput& VehicleInput = PhysicsInput.Vehicles.AddDefaulted_GetRef();
+	VehicleInput.VehicleActor = this;
+	VehicleInput.VehicleMeshPrim = VehicleMesh;
+	VehicleInput.VehicleMass = VehicleMesh->GetMass();
+	VehicleInput.VehicleInputs = InputsForPhysicsThread;
+	VehicleInput.SimulationTier = SimulationTier;
+	VehicleInput.ContactCacheTolerance = UseContactCache ? ContactCacheTolerance : 0.0f;
+	VehicleInput.ContactCacheMaxSteps = static_cast<uint32>(FMath::Max(ContactCacheMaxSteps, 1));
+	VehicleInput.SurfaceGrid = (UseSurfaceGrid && PhysicsSubsystem->GetSurfaceGrid()) ? PhysicsSubsystem->GetSurfaceGrid()->GetGridData() : nullptr;
+	VehicleInput.Drivetrain = NativeDrivetrain ? DrivetrainConfig : nullptr;
+	VehicleInput.FirstWheel = PhysicsInput.Wheels.Num();
+	VehicleInput.NumWheels = SimulatedWheels.Num();
+	VehicleInput.WheelConfigVersion = WheelConfigVersion;
+
+	for( const UVehicleWheelBase* Wheel : SimulatedWheels )
+	{
+		FAVS_WheelDynamicInput& WheelInput = PhysicsInput.Wheels.AddDefaulted_GetRef();
+		WheelInput.IsLocked = Wheel->GetIsLocked();
+	}
+
+	// Full configs are only sent until the physics thread reports them as applied, inputs can be skipped between steps
+	if( AppliedWheelConfigVersion != WheelConfigVersion )
+	{
+		VehicleInput.FirstWheelConfig = PhysicsInput.WheelConfigs.Num();
+		for( const UVehicleWheelBase* Wheel : SimulatedWheels )
+		{
+			PhysicsInput.WheelConfigs.Add(Wheel->WheelConfig);
+			PhysicsInput.WheelTireTables.Add(IsValid(Wheel->WheelConfig.TireModel) ? Wheel->WheelConfig.TireModel->GetTable() : nullptr);
+		}
+	}
+}
+
+void AVehicleSystemBase::UpdateSimulationTier()
+{
+	if( !UseSimulationTiers || IsPlayerControlled() )
+	{
+		SimulationTier = EVehicleSimulationTier::Full;
+		return;
+	}
+
+	// Closest view of any player, the server sees every player controller, clients only their own
+	float ClosestDistance = TNumericLimits<float>::Max();
+	bool HasPlayerView = false;
+	for( FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator )
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if( PlayerController == nullptr ) continue;
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		const FVector ToVehicle = GetActorLocation() - ViewLocation;
+		float DistanceMeters = ToVehicle.Size() * 0.01f;
+		if( FVector::DotProduct(ViewRotation.Vector(), ToVehicle) < 0.0f )
+		{
+			DistanceMeters *= SimulationTierOutOfViewScale; // Behind the camera
+		}
+		ClosestDistance = FMath::Min(ClosestDistance, DistanceMeters);
+		HasPlayerView = true;
+	}
+	if( !HasPlayerView )
+	{
+		SimulationTier = EVehicleSimulationTier::Full; // Nobody to measure against, e.g. a server before any player joined
+		return;
+	}
+
+	auto TierAtDistance = [this](float Distance)
+	{
+		if( Distance > KinematicTierDistance ) return EVehicleSimulationTier::Kinematic;
+		if( Distance > ReducedTierDistance ) return EVehicleSimulationTier::Reduced;
+		return EVehicleSimulationTier::Full;
+	};
+
+	// Lower detail only past the outer edge of the band, higher detail only past the inner edge
+	const EVehicleSimulationTier MostDetailAllowed = TierAtDistance(ClosestDistance / (1.0f + SimulationTierHysteresis));
+	const EVehicleSimulationTier LeastDetailAllowed = TierAtDistance(ClosestDistance / (1.0f - SimulationTierHysteresis));
+	if( SimulationTier < MostDetailAllowed ) SimulationTier = MostDetailAllowed;
+	else if( SimulationTier > LeastDetailAllowed ) SimulationTier = LeastDetailAllowed;
+}
+
+void AVehicleSystemBase::UpdateWheelVisuals(float DeltaTime)
+{
+	WheelVisualTime += DeltaTime;
+	if( WheelVisualTime < GetWheelVisualInterval() ) return;
+	AVS_SCOPE_CYCLE_COUNTER(WheelVisuals);
+
+	// One pass over every wheel instead of a tick per wheel component
+	for( UVehicleWheelBase* Wheel : VehicleWheels )
+	{
+		Wheel->UpdateVisuals(WheelVisualTime);
+	}
+	WheelVisualTime = 0.0f;
+}
+
+float AVehicleSystemBase::GetWheelVisualInterval() const
+{
+	if( !VehicleMesh->WasRecentlyRendered(0.2f) )
+	{
+		return WheelVisualHiddenRate > 0.0f ? 1.0f / WheelVisualHiddenRate : 0.0f;
+	}
+
+	// Closest local player view, split screen has one per player
+	float ClosestDistanceSquared = TNumericLimits<float>::Max();
+	for( FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator )
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if( PlayerController == nullptr || !PlayerController->IsLocalController() || PlayerController->PlayerCameraManager == nullptr )
+			continue;
+
+		ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, (float)FVector::DistSquared(PlayerController->PlayerCameraManager->GetCameraLocation(), GetActorLocation()));
+	}
+
+	const float LODDistance = WheelVisualLODDistance * 100.0f; // Meters to cm
+	if( ClosestDistanceSquared > LODDistance * LODDistance && WheelVisualFarRate > 0.0f )
+	{
+		return 1.0f / WheelVisualFarRate;
+	}
+	return 0.0f;
+}
+
+void AVehicleSystemBase::UpdateDrivetrain()
+{
+	TSharedPtr<FAVS_DrivetrainConfig, ESPMode::ThreadSafe> NewConfig = MakeShared<FAVS_DrivetrainConfig, ESPMode::ThreadSafe>();
+	NewConfig->Gears = Gears;
+	NewConfig->SpeedScale = GearSpeedScale;
+	NewConfig->ShiftTime = ShiftTime;
+	NewConfig->Differential = Differential;
+	NewConfig->LimitedSlipLocking = LimitedSlipLocking;
+
+	// Bake the torque curve up to the highest RPM any gear reaches, an empty curve leaves the gear torque as is
+	const FRichCurve* TorqueCurve = EngineTorqueCurve.GetRichCurveConst();
+	if( TorqueCurve != nullptr && TorqueCurve->GetNumKeys() > 0 )
+	{
+		float MaxRPM = 0.0f;
+		for( const FVehicleGear& Gear : Gears )
+		{
+			MaxRPM = FMath::Max3(MaxRPM, Gear.LowRPM, Gear.HighRPM);
+		}
+		constexpr int32 NumSamples = 64;
+		NewConfig->TorqueTableStep = FMath::Max(MaxRPM, 1.0f) / (NumSamples - 1);
+		NewConfig->TorqueTable.SetNumUninitialized(NumSamples);
+		for( int32 Sample = 0; Sample < NumSamples; ++Sample )
+		{
+			NewConfig->TorqueTable[Sample] = TorqueCurve->Eval(Sample * NewConfig->TorqueTableStep, 1.0f);
+		}
+	}
+
+	DrivetrainConfig = NewConfig; // Steps already in flight keep the old config alive
+}
+
+void AVehicleSystemBase::UpdateSimulatedWheels()
+{
+	// Check the cached list against the current wheels without allocating
+	bool WheelsChanged = false;
+	bool ConfigChanged = false;
+	int32 NumSimulated = 0;
+	for( UVehicleWheelBase* Wheel : VehicleWheels )
+	{
+		if( !IsValid(Wheel) || !Wheel->GetIsAttached() || !Wheel->GetIsSimulatingSuspension() ) continue;
+
+		Wheel->DetectWheelConfigChange();
+		if( !SimulatedWheels.IsValidIndex(NumSimulated) || SimulatedWheels[NumSimulated] != Wheel )
+		{
+			WheelsChanged = true;
+			break;
+		}
+		if( SimulatedWheelVersions[NumSimulated] != Wheel->GetWheelConfigVersion() )
+		{
+			SimulatedWheelVersions[NumSimulated] = Wheel->GetWheelConfigVersion();
+			ConfigChanged = true;
+		}
+		++NumSimulated;
+	}
+	if( !WheelsChanged && NumSimulated != SimulatedWheels.Num() ) WheelsChanged = true; // Wheels were removed from the end
+
+	if( WheelsChanged )
+	{
+		SimulatedWheels.Reset();
+		SimulatedWheelVersions.Reset();
+		for( UVehicleWheelBase* Wheel : VehicleWheels )
+		{
+			if( !IsValid(Wheel) || !Wheel->GetIsAttached() || !Wheel->GetIsSimulatingSuspension() ) continue;
+
+			SimulatedWheels.Add(Wheel);
+			SimulatedWheelVersions.Add(Wheel->GetWheelConfigVersion());
+		}
+	}
+
+	if( WheelsChanged || ConfigChanged ) ++WheelConfigVersion;
+}
+
 // Tick that uses minimal resources
 void AVehicleSystemBase::PassiveTick(float DeltaTime)
 {
@@ -246,13 +535,21 @@ void AVehicleSystemBase::Tick(float DeltaTime)
 void AVehicleSystemBase::NetworkTick()
 {
 	NetworkRoles CurrentRole = GetNetworkRole();
-	if( CurrentRole != NetworkRoles::Owner )
+	if( CurrentRole != NetworkRoles::Owner && !IsSimulationAuthority() )
 	{
 		if (ReplicateMovement && ShouldSyncWithServer)
 		{
 			SyncPhysics();
 		}
 	}
+	else if( ServerAuthoritative && CurrentRole == NetworkRoles::Owner && !isServer() )
+	{
+		if (ReplicateMovement && ShouldSyncWithServer)
+		{
+			SendPredictionInputs();
+			ApplyServerCorrection();
+		}
+	}
 
 	// Update camera manager for network relevancy
 	if( (CurrentRole != NetworkRoles::Server) && IsNetMode(NM_Client) )
@@ -286,22 +583,32 @@ void AVehicleSystemBase::UpdateInternalWheelArray()
 
 bool AVehicleSystemBase::IsPhysicsCallbackRegistered()
 {
-	return PhysicsThreadCallback != nullptr;
+	return IsValid(PhysicsSubsystem) && PhysicsSubsystem->IsVehicleRegistered(this);
 }
 
 void AVehicleSystemBase::RegisterPhysicsCallback()
 {
 	if (UWorld* World = GetWorld())
 	{
-		if (FPhysScene* PhysScene = World->GetPhysicsScene())
+		PhysicsSubsystem = World->GetSubsystem<UVehiclePhysicsSubsystem>();
+		if (PhysicsSubsystem && PhysicsSubsystem->RegisterVehicle(this))
 		{
-			PhysicsThreadCallback = PhysScene->GetSolver()->CreateAndRegisterSimCallbackObject_External<FVehiclePhysicsCallback>(); // Unreal 5.1+
-			PhysicsThreadCallback->VehicleMesh = VehicleMesh->GetBodyInstance()->GetPhysicsActorHandle();
-			VehicleMesh->GetBodyInstance()->SetContactModification(true);
+			// Only for games that modify contacts from their own callback, wheel collisions are filtered without it
+			VehicleMesh->GetBodyInstance()->SetContactModification(UseContactModification);
 		}
 	}
 }
 
+void AVehicleSystemBase::UnregisterPhysicsCallback()
+{
+	if(IsPhysicsCallbackRegistered())
+	{
+		PhysicsSubsystem->SetDisabledCollisions(VehicleMesh->GetBodyInstance()->GetPhysicsActorHandle(), {});
+		PhysicsSubsystem->UnregisterVehicle(this);
+	}
+	PhysicsSubsystem = nullptr;
+}
+
 void AVehicleSystemBase::WakeWheelsForMovement_Implementation()
 {
 	// Used in blueprint
@@ -334,36 +641,46 @@ void AVehicleSystemBase::SetReplicationTimer(bool Enabled)
 
 void AVehicleSystemBase::NetStateSend()
 {
-	if (GetNetworkRole() == NetworkRoles::Owner)
+	if( IsSimulationAuthority() )
 	{
 		FNetState NewState = CreateNetStateForNow();
 
 		// Only send while not at rest
 		if (!LocalVehicleAtRest) // Not at rest
 		{
-			Server_ReceiveNetState(NewState); // Send moving state
-			if (NetworkAtRest) // NetRest is resting but should not be
+			if (NetworkAtRest) // NetRest is resting but should not be, reset first so a dormant vehicle is awake for the moving state
 			{
 				FNetState BlankRestState;
 				Server_ReceiveRestState(BlankRestState); // Reset NetRest
 			}
+			Server_ReceiveNetState(NewState); // Send moving state
 		}
 		else // Is at rest
 		{
 			// NetworkAtRest is not true but should be, or distance is too different
-			const float DistanceThreshold = VehicleMesh->RigidBodyIsAwake() ? 50.0f : 0.5f; // Greater threshold if physics is awake to prevent constantly syncing
+			const float DistanceThreshold = VehicleMesh->RigidBodyIsAwake() ? 50.0f : FMath::Max(0.5f, FNetState::GetPositionTolerance(NetStatePrecision)); // Greater threshold if physics is awake to prevent constantly syncing, never below the quantization error
 			const float MoveDistance = UVehicleSystemFunctions::FastDist(RestState.position, NewState.position);
 			if( !NetworkAtRest || MoveDistance > DistanceThreshold )
 			{
 				UAVS_DEBUG::SCREEN(EDebugCategory::NETWORK, TXT("%s -- Update RestState // Dist %f > DistThreshold %f", *GetFName().ToString(), MoveDistance, DistanceThreshold));
 				Server_ReceiveRestState(NewState);
 			}
+			else if( HasAuthority() )
+			{
+				UpdateRestDormancy(); // Possession may have woken the actor up while it stayed at rest
+			}
 		}
 
 		if (StateQueue.Num() > 0)
 		{
 			ClearQueue(); //Clear the queue if we are the owner to avoid syncing to old states
 		}
+
+		// The predicting owner compares this with where it was when the server applied its latest input
+		if( GetNetworkRole() == NetworkRoles::Server )
+		{
+			Client_ReceiveSnapshot(NewState, LastInputSequence, GetLocalWorldTime() - LastInputTime);
+		}
 	}
 }
 
@@ -376,6 +693,7 @@ FNetState AVehicleSystemBase::CreateNetStateForNow()
 	newState.velocity = VehicleMesh->GetPhysicsLinearVelocity();
 	newState.angularVelocity = VehicleMesh->GetPhysicsAngularVelocityInDegrees();
 	newState.NetTimestamp = GetNetworkWorldTime();
+	newState.Precision = NetStatePrecision;
 	return newState;
 }
 
@@ -385,7 +703,29 @@ bool AVehicleSystemBase::Server_ReceiveNetState_Validate(FNetState State)
 }
 void AVehicleSystemBase::Server_ReceiveNetState_Implementation(FNetState State)
 {
-	Client_ReceiveNetState(State);
+	AVS_SCOPE_CYCLE_COUNTER(NetReceive);
+	State.UnwrapTimestamp(GetNetworkWorldTime());
+	if( !UseNetSendLOD )
+	{
+		Client_ReceiveNetState(State);
+		return;
+	}
+
+	// The server follows the owner like any other client
+	Client_ReceiveNetState_Implementation(State);
+
+	// Every remote connection gets its own rate, the owner and local controllers already have this state
+	for( FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It )
+	{
+		APlayerController* PlayerController = It->Get();
+		if( PlayerController == nullptr || PlayerController->IsLocalController() || PlayerController == GetController() )
+			continue;
+
+		if( UVehicleNetRelay* Relay = UVehicleNetRelay::FindOrAddRelay(PlayerController) )
+		{
+			Relay->RelayState(this, State);
+		}
+	}
 }
 
 bool AVehicleSystemBase::Client_ReceiveNetState_Validate(FNetState State)
@@ -394,9 +734,12 @@ bool AVehicleSystemBase::Client_ReceiveNetState_Validate(FNetState State)
 }
 void AVehicleSystemBase::Client_ReceiveNetState_Implementation(FNetState State)
 {
+	AVS_SCOPE_CYCLE_COUNTER(NetReceive);
+	State.UnwrapTimestamp(GetNetworkWorldTime());
 	if(ShouldSyncWithServer)
 	{
 		AddStateToQueue(State);
+		if( PassiveSleeping ) WakeFromPassive(); // Moving states only arrive while the simulating copy is awake
 	}
 }
 
@@ -406,8 +749,25 @@ bool AVehicleSystemBase::Server_ReceiveRestState_Validate(FNetState State)
 }
 void AVehicleSystemBase::Server_ReceiveRestState_Implementation(FNetState State)
 {
+	State.UnwrapTimestamp(GetNetworkWorldTime());
 	RestState = State; // Clients should still receive even when not actively syncing
 	if(GetLocalRole() == ROLE_Authority) {OnRep_RestState();} //RepNotify on Server
+
+	if( UseRestManager )
+	{
+		if( AVehicleRestManager* RestManager = AVehicleRestManager::Get(GetWorld(), NetworkAtRest) )
+		{
+			RestManager->SetRestState(this, State);
+		}
+		UpdateRestDormancy();
+	}
+}
+
+void AVehicleSystemBase::UpdateRestDormancy()
+{
+	// Clients can only send RPCs through awake actors, vehicles owned or driven by a player stay awake
+	const bool Dormant = UseRestManager && NetworkAtRest && !IsPlayerControlled() && GetNetConnection() == nullptr;
+	SetNetDormancy(Dormant ? DORM_DormantAll : DORM_Awake);
 }
 
 bool AVehicleSystemBase::Multicast_ChangedOwner_Validate()
@@ -416,77 +776,207 @@ bool AVehicleSystemBase::Multicast_ChangedOwner_Validate()
 }
 void AVehicleSystemBase::Multicast_ChangedOwner_Implementation()
 {
+	WakeFromPassive();
 	ClearQueue();
+	ResetPrediction();
 	OwnerChanged();
 }
 
-void AVehicleSystemBase::AddStateToQueue(FNetState StateToAdd)
+bool AVehicleSystemBase::Server_ReceiveInputs_Validate(const TArray<FAVS_InputFrame>& Frames)
 {
-	if (GetNetworkRole() != NetworkRoles::Owner)
+	return Frames.Num() <= 8;
+}
+void AVehicleSystemBase::Server_ReceiveInputs_Implementation(const TArray<FAVS_InputFrame>& Frames)
+{
+	if( !ServerAuthoritative )
+		return;
+
+	// Frames are resent several times, only the newest unseen one matters
+	const FAVS_InputFrame* NewestFrame = nullptr;
+	for( const FAVS_InputFrame& Frame : Frames )
 	{
-		// If we have 10 or more states we are flooded and should drop new states
-		if (StateQueue.Num() < 10)
+		if( Frame.Sequence > LastInputSequence && (NewestFrame == nullptr || Frame.Sequence > NewestFrame->Sequence) )
 		{
-			StateToAdd.NetTimestamp += NetTimeBehind; //Change the timestamp to the future so we can lerp
+			NewestFrame = &Frame;
+		}
+	}
+	if( NewestFrame == nullptr )
+		return; // Every frame is older than the last one applied
+
+	// Owner inputs are limited to the range local inputs can reach
+	FAVS_Inputs Inputs = NewestFrame->Inputs;
+	Inputs.Steering = FMath::IsFinite(Inputs.Steering) ? FMath::Clamp(Inputs.Steering, -1.0f, 1.0f) : 0.0f;
+	Inputs.Throttle = FMath::IsFinite(Inputs.Throttle) ? FMath::Clamp(Inputs.Throttle, 0.0f, 1.0f) : 0.0f;
+	Inputs.Brake = FMath::IsFinite(Inputs.Brake) ? FMath::Clamp(Inputs.Brake, 0.0f, 1.0f) : 0.0f;
+
+	// The native drivetrain computes torque on the physics thread, otherwise the owner's torque is kept within the allowed maximum
+	const float MaxTorque = GetMaxInputTorque();
+	Inputs.Torque = (NativeDrivetrain || !FMath::IsFinite(Inputs.Torque)) ? 0.0f : FMath::Max(Inputs.Torque, 0.0f);
+	if( MaxTorque > 0.0f ) Inputs.Torque = FMath::Min(Inputs.Torque, MaxTorque);
+
+	PhysicsThreadInputs(Inputs);
+	LastInputSequence = NewestFrame->Sequence;
+	LastInputTime = GetLocalWorldTime();
+}
 
-			if( StateToAdd.NetTimestamp < LastActiveTimestamp )
-			{
-				return; // This state is late and should be discarded
-			}
+float AVehicleSystemBase::GetMaxInputTorque() const
+{
+	if( NetMaxInputTorque > 0.0f )
+		return NetMaxInputTorque;
 
-			if (StateQueue.IsValidIndex(0))
-			{
-				int8 lastindex = StateQueue.Num() - 1;
-				for (int8 i = lastindex; i >= 0; --i)
-				{
-					if (StateQueue.IsValidIndex(i))
-					{
-						if( StateQueue[i].NetTimestamp < StateToAdd.NetTimestamp )
-						{
-							StateQueue.Insert(StateToAdd, i + 1);
-							CalculateTimestamps();
-							StateToAdd.LocalTimestamp = StateQueue[i + 1].NetTimestamp;
-							break;
-						}
-					}
-				}
-			}
-			else
-			{
-				StateToAdd.LocalTimestamp = GetLocalWorldTime() + NetTimeBehind;
-				StateQueue.Insert(StateToAdd, 0); // If the queue is empty just add it in the first spot
-			}
+	// Highest torque any gear reaches, including the engine torque curve
+	float MaxTorque = 0.0f;
+	for( const FVehicleGear& Gear : Gears )
+	{
+		MaxTorque = FMath::Max3(MaxTorque, Gear.MaxTorque, Gear.MinTorque);
+	}
+	float MaxMultiplier = 1.0f;
+	if( DrivetrainConfig.IsValid() && DrivetrainConfig->TorqueTable.Num() > 0 )
+	{
+		MaxMultiplier = FMath::Max(DrivetrainConfig->TorqueTable);
+	}
+	return MaxTorque * MaxMultiplier;
+}
+
+void AVehicleSystemBase::Client_ReceiveSnapshot_Implementation(FNetState State, int32 AckSequence, float AckAge)
+{
+	if( !ServerAuthoritative || PredictionHistory.Num() == 0 || AckSequence <= 0 )
+		return; // Server has not applied any of our inputs yet
+
+	// Oldest frame that sent the acked input, the snapshot was taken AckAge after the server applied it
+	const int32 HistorySize = PredictionHistory.Num();
+	int32 StartIndex = INDEX_NONE;
+	for( int32 Age = HistorySize; Age > 0; --Age )
+	{
+		const int32 Index = (PredictionHead - Age + HistorySize) % HistorySize;
+		if( PredictionHistory[Index].Sequence == AckSequence )
+		{
+			StartIndex = Index;
+			break;
 		}
 	}
+	if( StartIndex == INDEX_NONE )
+		return; // Older than the history, wait for a newer snapshot
+
+	const float TargetTime = PredictionHistory[StartIndex].Time + AckAge;
+	const FPredictedState* Predicted = &PredictionHistory[StartIndex];
+	for( int32 Index = (StartIndex + 1) % HistorySize; Index != PredictionHead; Index = (Index + 1) % HistorySize )
+	{
+		const FPredictedState& Candidate = PredictionHistory[Index];
+		if( FMath::Abs(Candidate.Time - TargetTime) > FMath::Abs(Predicted->Time - TargetTime) ) break;
+		Predicted = &Candidate;
+	}
+
+	const FVector PositionError = State.position - Predicted->Position;
+	const FQuat RotationError = State.rotation.Quaternion() * Predicted->Rotation.Inverse();
+	if( PositionError.Size() < NetCorrectionThreshold && FMath::RadiansToDegrees(RotationError.GetAngle()) < 2.0f )
+	{
+		PendingPositionCorrection = FVector::ZeroVector;
+		PendingRotationCorrection = FQuat::Identity;
+		PendingVelocityCorrection = FVector::ZeroVector;
+		return;
+	}
+
+	// Replaces any pending correction, the history already includes the part applied so far
+	PendingPositionCorrection = PositionError;
+	PendingRotationCorrection = RotationError;
+	PendingVelocityCorrection = State.velocity - Predicted->Velocity;
 }
 
-void AVehicleSystemBase::ClearQueue()
+void AVehicleSystemBase::SendPredictionInputs()
 {
-	StateQueue.Empty();
-	CreateNewStartState = true;
+	const float CurrentTime = GetLocalWorldTime();
+
+	// New frame whenever the inputs change, unchanged inputs are resent every NetSendRate so snapshots keep being acked
+	const FAVS_Inputs& Inputs = InputsForPhysicsThread;
+	const FAVS_Inputs* LastInputs = RecentInputFrames.Num() > 0 ? &RecentInputFrames.Last().Inputs : nullptr;
+	const bool InputsChanged = LastInputs == nullptr || LastInputs->Steering != Inputs.Steering || LastInputs->Throttle != Inputs.Throttle ||
+		LastInputs->Brake != Inputs.Brake || LastInputs->Handbrake != Inputs.Handbrake || LastInputs->Torque != Inputs.Torque || LastInputs->ReverseTorque != Inputs.ReverseTorque;
+	if( InputsChanged || CurrentTime - LastInputSendTime >= NetSendRate )
+	{
+		if( RecentInputFrames.Num() >= 3 ) RecentInputFrames.RemoveAt(0);
+		RecentInputFrames.Add({++InputSequence, Inputs});
+		Server_ReceiveInputs(RecentInputFrames);
+		LastInputSendTime = CurrentTime;
+	}
+
+	if( PredictionHistory.Num() != FMath::Max(NetPredictionHistory, 8) )
+	{
+		PredictionHistory.SetNumZeroed(FMath::Max(NetPredictionHistory, 8));
+		PredictionHead = 0;
+	}
+
+	const FTransform& MeshTransform = VehicleMesh->GetComponentTransform();
+	PredictionHistory[PredictionHead] = {CurrentTime, InputSequence, MeshTransform.GetLocation(), MeshTransform.GetRotation(), VehicleMesh->GetPhysicsLinearVelocity()};
+	PredictionHead = (PredictionHead + 1) % PredictionHistory.Num();
+}
+
+void AVehicleSystemBase::ApplyServerCorrection()
+{
+	if( PendingPositionCorrection.IsNearlyZero() && PendingRotationCorrection.Equals(FQuat::Identity) && PendingVelocityCorrection.IsNearlyZero() )
+		return;
+
+	// Spread the correction over several frames unless it is too far to be hidden, velocity is blended at the same rate
+	const float Distance = PendingPositionCorrection.Size();
+	const bool Teleport = Distance > 3000.0f;
+	const float Alpha = (Teleport || Distance <= NetCorrectionBudget) ? 1.0f : NetCorrectionBudget / Distance;
+	const FVector PositionStep = PendingPositionCorrection * Alpha;
+	const FQuat RotationStep = FQuat::Slerp(FQuat::Identity, PendingRotationCorrection, Alpha);
+	const FVector VelocityStep = PendingVelocityCorrection * Alpha;
+
+	const FTransform& MeshTransform = VehicleMesh->GetComponentTransform();
+	SetActorLocationAndRotation(MeshTransform.GetLocation() + PositionStep, RotationStep * MeshTransform.GetRotation(), false, nullptr, TeleportFlagToEnum(true));
+	VehicleMesh->SetPhysicsLinearVelocity(VehicleMesh->GetPhysicsLinearVelocity() + VelocityStep);
+	if( Teleport ) TeleportWheels();
+
+	// Inputs are not replayed, the history is shifted by the applied correction so the next snapshot is compared against the smoothed path
+	for( FPredictedState& Entry : PredictionHistory )
+	{
+		Entry.Position += PositionStep;
+		Entry.Rotation = RotationStep * Entry.Rotation;
+		Entry.Velocity += VelocityStep;
+	}
+	PendingPositionCorrection -= PositionStep;
+	PendingVelocityCorrection -= VelocityStep;
+	PendingRotationCorrection = Alpha >= 1.0f ? FQuat::Identity : PendingRotationCorrection * RotationStep.Inverse();
+}
+
+void AVehicleSystemBase::ResetPrediction()
+{
+	PredictionHistory.Reset();
+	PredictionHead = 0;
+	RecentInputFrames.Reset();
+	InputSequence = 0;
+	LastInputSequence = 0;
+	PendingPositionCorrection = FVector::ZeroVector;
+	PendingRotationCorrection = FQuat::Identity;
+	PendingVelocityCorrection = FVector::ZeroVector;
 }
 
-void AVehicleSystemBase::CalculateTimestamps()
+void AVehicleSystemBase::AddStateToQueue(FNetState StateToAdd)
 {
-	int8 lastindex = StateQueue.Num() - 1;
-	for (int8 i = 0; i <= lastindex; i++)
+	if (GetNetworkRole() != NetworkRoles::Owner)
 	{
-		// The first state is always our point of reference and should not change
-		// Especially since it could be actively syncing
-		if(i != 0)
+		if( StateQueue.Add(StateToAdd, GetLocalWorldTime()) ) // Late states are discarded
 		{
-			if (StateQueue.IsValidIndex(i))
-			{
-				// Calculate the time difference in the owners times and apply it to our local times
-				float timeDifference = StateQueue[i].NetTimestamp - StateQueue[i - 1].NetTimestamp;
-				StateQueue[i].LocalTimestamp = StateQueue[i - 1].LocalTimestamp + timeDifference;
-			}
+			INC_DWORD_STAT(STAT_AVS_StatesQueued);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_AVS_StatesDropped);
 		}
 	}
 }
 
+void AVehicleSystemBase::ClearQueue()
+{
+	StateQueue.Reset();
+	CreateNewStartState = true;
+}
+
 void AVehicleSystemBase::SyncPhysics()
 {
+	AVS_SCOPE_CYCLE_COUNTER(NetInterpolate);
 	if( NetworkAtRest )
 	{
 		SetVehicleLocation(RestState.position, RestState.rotation, true);
@@ -503,48 +993,49 @@ void AVehicleSystemBase::SyncPhysics()
 		return;
 	}
 
-	if (StateQueue.IsValidIndex(0))
-	{
-		FNetState NextState = StateQueue[0];
-		float CurrentTime = GetLocalWorldTime();
+	if( StateQueue.Num() == 0 )
+		return;
 
-		// use physics until we are close enough to this timestamp
-		if( CurrentTime >= (NextState.LocalTimestamp - NetLerpStart) )
-		{
-			if (CreateNewStartState)
-			{
-				LerpStartState = CreateNetStateForNow();
-				CreateNewStartState = false;
-
-					// If our start state is nearly equal to our end state, just skip it
-					// This keeps the physics from looking weird when moving slowly, and allows physics to settle
-				if (FMath::IsNearlyEqual(LerpStartState.position.X, NextState.position.X, NetPositionTolerance) &&
-                    FMath::IsNearlyEqual(LerpStartState.position.Y, NextState.position.Y, NetPositionTolerance) &&
-                    FMath::IsNearlyEqual(LerpStartState.position.Z, NextState.position.Z, NetPositionTolerance))
-				{
-					StateQueue.RemoveAt(0);
-					CreateNewStartState = true;
-					return;
-				}
-			}
+	const float CurrentTime = GetLocalWorldTime();
+	const float RenderTime = StateQueue.GetRenderTime(CurrentTime, NetTimeBehind);
+	StateQueue.DiscardBefore(RenderTime);
 
-			LastActiveTimestamp = NextState.NetTimestamp;
+	// use physics until the oldest state is due
+	FNetState SampledState;
+	if( !StateQueue.Sample(RenderTime, NetMaxExtrapolation, SampledState) )
+		return;
 
-			// Lerp To State
-			// Our start state may have been created after the lerp start time, so choose whatever is latest
-			float lerpBeginTime = LerpStartState.NetTimestamp;
-			float lerpPercent = FMath::Clamp(GetPercentBetweenValues(CurrentTime, lerpBeginTime, NextState.LocalTimestamp), 0.0f, 1.0f);
-			FVector NewPosition = UKismetMathLibrary::VLerp(LerpStartState.position, NextState.position, lerpPercent);
-			FRotator NewRotation = UKismetMathLibrary::RLerp(LerpStartState.rotation, NextState.rotation, lerpPercent, true);
-			SetVehicleLocation(NewPosition, NewRotation);
+	if( CreateNewStartState )
+	{
+		LerpStartState = CreateNetStateForNow();
+		LerpStartState.LocalTimestamp = CurrentTime;
+		CreateNewStartState = false;
+	}
 
-			if( lerpPercent >= 0.99f || lerpBeginTime > NextState.LocalTimestamp )
-			{
-				ApplyExactNetState(NextState);
-				StateQueue.RemoveAt(0);
-				CreateNewStartState = true;
-			}
-		}
+	// Blend in from wherever physics left the vehicle
+	const float BlendPercent = NetLerpStart > 0.0f ? FMath::Clamp(GetPercentBetweenValues(CurrentTime, LerpStartState.LocalTimestamp, LerpStartState.LocalTimestamp + NetLerpStart), 0.0f, 1.0f) : 1.0f;
+	const FVector NewPosition = UKismetMathLibrary::VLerp(LerpStartState.position, SampledState.position, BlendPercent);
+	const FRotator NewRotation = UKismetMathLibrary::RLerp(LerpStartState.rotation, SampledState.rotation, BlendPercent, true);
+
+	// If we are nearly at the sampled state and it is not moving, leave physics alone so it can settle
+	const FVector CurrentPosition = VehicleMesh->GetComponentLocation();
+	if( SampledState.velocity.SizeSquared() < FMath::Square(RestVelocityThreshold) &&
+		FMath::IsNearlyEqual(CurrentPosition.X, NewPosition.X, NetPositionTolerance) &&
+		FMath::IsNearlyEqual(CurrentPosition.Y, NewPosition.Y, NetPositionTolerance) &&
+		FMath::IsNearlyEqual(CurrentPosition.Z, NewPosition.Z, NetPositionTolerance))
+	{
+		return;
+	}
+
+	SetVehicleLocation(NewPosition, NewRotation);
+
+	// Match the sender's velocity every time a new state is reached, physics carries the vehicle in between
+	const float ActiveTimestamp = StateQueue.Get(0).NetTimestamp;
+	if( ActiveTimestamp != LastActiveTimestamp && BlendPercent >= 1.0f )
+	{
+		LastActiveTimestamp = ActiveTimestamp;
+		VehicleMesh->SetPhysicsLinearVelocity(SampledState.velocity);
+		VehicleMesh->SetPhysicsAngularVelocityInDegrees(SampledState.angularVelocity);
 	}
 }
 
@@ -627,247 +1118,428 @@ void AVehicleSystemBase::SetVehicleLocation(const FVector& InNewPos, const FRota
 	}
 }
 
-void AVehicleSystemBase::AVS_PhysicsTick(float ChaosDelta, const FVehiclePhysicsPhysicsInput* PhysicsInput, FVehiclePhysicsPhysicsOutput& PhysicsOutput)
+bool AVehicleSystemBase::AVS_GatherWheelQueries(const FAVS_VehiclePhysicsInput& PhysicsInput, TConstArrayView<FAVS1_Wheel_Config> WheelConfigs,
+	TConstArrayView<TSharedPtr<const FAVS_TireTable, ESPMode::ThreadSafe>> TireTables, TConstArrayView<FAVS_WheelDynamicInput> Wheels, FAVS_WheelQueryBatch& QueryBatch)
 {
-	using namespace Chaos;
+	// Configs only arrive when they change, the store keeps the last ones otherwise
+	if( PhysicsInput.FirstWheelConfig != INDEX_NONE && PhysicsInput.WheelConfigVersion != WheelStore.ConfigVersion )
+	{
+		WheelStore.SetNum(WheelConfigs.Num());
+		for( int32 WIndex = 0; WIndex < WheelConfigs.Num(); ++WIndex )
+		{
+			WheelStore.SetWheelConfig(WIndex, WheelConfigs[WIndex], TireTables[WIndex], this);
+		}
+		WheelStore.ConfigVersion = PhysicsInput.WheelConfigVersion;
+	}
 
-	UWorld* World = PhysicsInput->World.Get(); // only safe to access for scene queries
-	if( World == nullptr ) return;
-	
-	FTransform VehicleBodyTransform = UVehicleSystemFunctions::AVS_GetChaosTransform(PhysicsInput->VehicleMeshPrim);
-	TArray<FAVS1_Wheel_Config> Wheels = PhysicsInput->Wheels;
-	
-	if( WheelStates.Num() != Wheels.Num() ) { WheelStates.SetNum(Wheels.Num()); } // Ensure wheel state array is in sync
-	
-	// Loop through each wheel
-	for( int32 WIndex = 0; WIndex < Wheels.Num(); ++WIndex )
+	if( WheelStore.Num() != Wheels.Num() ) return false; // Wheel set changed, wait for the new configs
+
+	PhysicsBodyTransform = UVehicleSystemFunctions::AVS_GetChaosTransform(PhysicsInput.VehicleMeshPrim);
+	++PhysicsStepCount;
+
+	// Dynamic objects are only checked once a wheel actually needs the grid
+	const FAVS_SurfaceGridData* SurfaceGrid = PhysicsInput.SurfaceGrid.Get();
+	bool SurfaceGridChecked = false;
+
+	for( int32 WIndex = 0; WIndex < WheelStore.Num(); ++WIndex )
 	{
-		FAVS1_Wheel_Output WheelOutput; // New output for this wheel
-		FAVS1_Wheel_Config WheelConfig = Wheels[WIndex]; // Current configuration from the game thread
-		FAVS1_Wheel_State& WheelState = WheelStates[WIndex]; // State data on the physics thread
+		WheelStore.SetFlag(WIndex, FAVS_WheelStore::WF_Locked, Wheels[WIndex].IsLocked);
 
-		FTransform WheelLocalTransform = WheelConfig.WheelLocalTransform;
-		if(WheelConfig.IsSteerableWheel) // Steering
+		FTransform WheelLocalTransform = WheelStore.LocalTransforms[WIndex];
+		if( WheelStore.HasFlag(WIndex, FAVS_WheelStore::WF_Steerable) ) // Steering
 		{
-			float SteeringAngle = PhysicsInput->VehicleInputs.Steering * WheelConfig.MaxSteeringAngle;
-			SteeringAngle = WheelConfig.InvertSteering ? (SteeringAngle * -1.0f) : SteeringAngle;
+			float SteeringAngle = PhysicsInput.VehicleInputs.Steering * WheelStore.MaxSteeringAngles[WIndex];
+			SteeringAngle = WheelStore.HasFlag(WIndex, FAVS_WheelStore::WF_InvertSteering) ? (SteeringAngle * -1.0f) : SteeringAngle;
 			WheelLocalTransform.SetRotation( WheelLocalTransform.TransformRotation(FRotator(0.0f, SteeringAngle, 0.0f).Quaternion()) );
 		}
 
 		// We have to calculate the wheel transform every frame because it doesn't have a body in the physics scene
-		FTransform WheelWorldTransform = FTransform( VehicleBodyTransform.TransformRotation(WheelLocalTransform.GetRotation()),
-			VehicleBodyTransform.TransformPosition(WheelLocalTransform.GetLocation()) );
-		FVector WheelWorldLocation = WheelWorldTransform.GetLocation();
-		FVector WheelWorldForward = WheelWorldTransform.GetUnitAxis( EAxis::X );
-		FVector WheelWorldRight = WheelWorldTransform.GetUnitAxis( EAxis::Y );
-		FVector WheelWorldUp = WheelWorldTransform.GetUnitAxis( EAxis::Z );
+		FTransform& WheelWorldTransform = WheelStore.WorldTransforms[WIndex];
+		WheelWorldTransform = FTransform( PhysicsBodyTransform.TransformRotation(WheelLocalTransform.GetRotation()),
+			PhysicsBodyTransform.TransformPosition(WheelLocalTransform.GetLocation()) );
+
+		const float TraceHalfLength = WheelStore.SpringLengths[WIndex]*0.5f + WheelStore.Radii[WIndex];
+		const FVector WheelWorldLocation = WheelWorldTransform.GetLocation();
+		const FVector WheelWorldUp = WheelWorldTransform.GetUnitAxis( EAxis::Z );
+		const FVector TraceStart = WheelWorldLocation + WheelWorldUp * TraceHalfLength; // Top of wheel while compressed
+		const FVector TraceEnd = WheelWorldLocation - WheelWorldUp * TraceHalfLength; // Bottom of wheel while extended
+
+		// Lower tiers only trace some wheels each step, the rest are solved against the plane of their last hit.
+		// Wheels without a known plane are always traced so they can land, sweep contacts do not give one
+		const FAVS_WheelHit& LastHit = WheelStore.LastHits[WIndex];
+		const bool HasLastPlane = LastHit.bBlockingHit && !LastHit.bSweepHit;
+		bool TraceWheel = true;
+		if( PhysicsInput.SimulationTier != EVehicleSimulationTier::Full && HasLastPlane )
+		{
+			TraceWheel = (PhysicsInput.SimulationTier == EVehicleSimulationTier::Reduced)
+				? ((WIndex + PhysicsStepCount) % 2 == 0)
+				: (WIndex == PhysicsStepCount % WheelStore.Num());
+		}
 
-		FVector TraceStart = WheelWorldLocation + WheelWorldUp * (WheelConfig.SpringLength*0.5f + WheelConfig.WheelRadius); // Top of wheel while compressed
-		FVector TraceEnd = WheelWorldLocation - WheelWorldUp * (WheelConfig.SpringLength*0.5f + WheelConfig.WheelRadius); // Bottom of wheel while extended
-		
-		FHitResult Trace;
-		bool TraceHit = UKismetSystemLibrary::LineTraceSingle(this, TraceStart, TraceEnd, UEngineTypes::ConvertToTraceType(WheelConfig.TraceChannel),
-															  true, WheelConfig.TraceIgnoreActors, EDrawDebugTrace::None, Trace, true);
-		AddDebugTrace(PhysicsOutput, Trace);
-		WheelOutput.LastTrace = Trace;
-		
-		if(TraceHit)
+		// Contact cache, a wheel close to its last trace over static ground hits the same plane again.
+		// Still traced if the plane is out of reach, the ground may continue past the edge of the cached one
+		bool Solved = false;
+		if( TraceWheel && PhysicsInput.ContactCacheTolerance > 0.0f && HasLastPlane && LastHit.bStaticComponent && LastHit.Component.IsValid()
+			&& (PhysicsStepCount - WheelStore.LastTraceSteps[WIndex]) < PhysicsInput.ContactCacheMaxSteps
+			&& FVector::DistSquared(WheelWorldLocation, WheelStore.LastTraceLocations[WIndex]) < FMath::Square(PhysicsInput.ContactCacheTolerance) )
 		{
-			// Length of spring right now while compressed
-			float Length = Trace.Distance - (WheelConfig.WheelRadius * 2.0f);
-			float NewSpringLength = TraceHit ? FMath::Clamp(Length, 0.0f, WheelConfig.SpringLength) : WheelConfig.SpringLength;
-			WheelOutput.CurrentSpringLength = NewSpringLength; // Used by game thread to place wheel mesh
-			
-			// Wheel World and Contact Velocity
-			const FVector WheelVelocityWorld = UVehicleSystemFunctions::AVS_ChaosGetVelocityAtLocation(PhysicsInput->VehicleMeshPrim, Trace.ImpactPoint);
-			const FVector WheelVelocityLocal = WheelWorldTransform.Inverse().TransformVectorNoScale(WheelVelocityWorld);
-			//UPrimitiveComponent* ContactComponent = HitResult.GetComponent(); // Get the contact object //TODO :: Chaos Thread equivalent
-			const FVector ContactCompVelocityWorld = FVector::ZeroVector;//ContactComponent->GetPhysicsLinearVelocityAtPoint(ImpactPoint);
-			const FVector WheelVelocityWorldM = (WheelVelocityWorld - ContactCompVelocityWorld) * 0.01f; // Velocity relative to contacted object (Meters/Second)
-			const FVector WheelVelocityProjected = FVector::VectorPlaneProject(WheelVelocityWorldM, Trace.ImpactNormal); // Project speed onto plane
-			const FVector WheelVelocityLocalM = WheelWorldTransform.InverseTransformVectorNoScale(WheelVelocityProjected); // Wheel velocity relative to vehicle (Meters/Second)
-
-			// Project the axes onto the plane
-			FVector ForwardOnPlane = FVector::VectorPlaneProject(WheelWorldForward, Trace.ImpactNormal); ForwardOnPlane.Normalize();
-			FVector RightOnPlane = FVector::VectorPlaneProject(WheelWorldRight, Trace.ImpactNormal); RightOnPlane.Normalize();
-			const float WheelVelocity = WheelVelocityProjected.Size(); // Wheel velocity in Meters/Second
-			FVector LinearVelocityOnPlaneNormalized; if (WheelVelocity != 0.0f) LinearVelocityOnPlaneNormalized = WheelVelocityProjected / WheelVelocity;
-
-			// Suspension
-			const float SpringStrengthNm = WheelConfig.SpringStrength * 1000.0f; // Spring Strength in N/m
-			const float ShockAbsorption = WheelConfig.SpringDamping * 1000.0f; // Spring Damper in Ns/m
-			const float CompressionDistanceM = (WheelConfig.SpringLength - NewSpringLength) * 0.01f; // Distance of compression in Meters
-			const float CompressionVelocityM = WheelVelocityLocal.Z * (-0.01f); // Velocity of compression in Meters/Second
-
-			float SpringForceN = SpringStrengthNm * CompressionDistanceM;
-			float DamperForceN = ShockAbsorption * CompressionVelocityM;
-
-			// Suspension :: Excess compression
-			if( Length < -1.0f )
+			Solved = LastHit.SolveAgainstPlane(TraceStart, TraceEnd, WheelStore.SolvedHits[WIndex]);
+			TraceWheel = !Solved;
+		}
+
+		// Baked ground, wheels only trace where the grid has no answer or something dynamic could be under them
+		if( TraceWheel && SurfaceGrid )
+		{
+			if( !SurfaceGridChecked )
 			{
-				const float VehicleMass = PhysicsInput->VehicleMass; // Mass Kg
-				const float Gravity = -World->GetGravityZ();
-				const float AntiGravityN = (Gravity * VehicleMass) * 0.01f;
-				
-				SpringForceN += AntiGravityN;
-				DamperForceN *= 2;
+				SurfaceGridChecked = true;
+				SurfaceGrid = AVS_HasDynamicObjectsNearWheels() ? nullptr : SurfaceGrid;
 			}
-
-			// Scale applied force by wheel's left/right tilt to prevent sudden thrusts when landing sideways
-			const float ImpactTilt = 1.0f - FMath::Abs(FVector::DotProduct(Trace.ImpactNormal, WheelWorldRight)); // 1.0f = Wheel is upright, 0.0f = Wheel is sideways (Relative to the Impact Normal)
-			constexpr float TiltFalloffStart = 0.5f; // Force starts dropping off here
-			constexpr float TiltFalloffEnd = 0.1f; // Zero force here
-			const float TiltFalloff = FMath::Clamp((ImpactTilt - TiltFalloffEnd) / (TiltFalloffStart - TiltFalloffEnd), 0.0f, 1.0f);
-
-			const float SuspensionForceN = (SpringForceN + DamperForceN) * TiltFalloff;
-			FVector SuspensionForceV = (Trace.ImpactNormal * SuspensionForceN) * 100.0f; // Final suspension force in CentiNewtons
-
-			if( WheelConfig.WheelMode == EWheelMode::Physics )
+			if( SurfaceGrid && SurfaceGrid->Trace(TraceStart, TraceEnd, WheelStore.SolvedHits[WIndex]) )
 			{
-				// Apply Suspension Forces
-				UVehicleSystemFunctions::AVS_ChaosAddForceAtLocation(PhysicsInput->VehicleMeshPrim, Trace.Location, SuspensionForceV);
-				UVehicleSystemFunctions::AVS_ChaosAddForce(WheelConfig.WheelPrim, -SuspensionForceV, false);
-				AddDebugForce(PhysicsOutput, FDebugForce(Trace.Location, SuspensionForceV, WheelConfig.WheelMode));
-				PhysicsOutput.WheelOutputs.Add(WheelOutput); // Add the wheel output since we are ending early
-
-				if( WheelConfig.IsBrakingWheel )
-				{
-					// Apply Brake Torque
-					float BrakeInput = PhysicsInput->VehicleInputs.Brake; // Set BrakeInput as user input if braking wheel
-					//BrakeInput = FMath::Clamp((BrakeInput * BrakePressure), WheelConfig.RollingResistance * 0.1f, 1.0f); // Clamp between Resistance & 1, RollingResistance can just be applied as brakes
-					if( BrakeInput > 0.0f ) UVehicleSystemFunctions::AVS_ChaosBrakes(WheelConfig.WheelPrim, WheelConfig.BrakeTorque * BrakeInput, ChaosDelta); // TODO: Get physics brake torque to properly accept Nm
-					// TODO Physics rolling resistance
-				}
-				
-				continue; // Finish this wheel here, the physics engine handles friction and torque
+				Solved = true;
+				TraceWheel = false;
 			}
+		}
 
-			// Friction
-			const float SurfaceFriction = (Trace.PhysMaterial.IsValid()) ? Trace.PhysMaterial->Friction : 1.0f;
-			FVector2D EffectiveFriction = WheelConfig.TireFriction * SurfaceFriction; // Friction combine method = Multiply
-			
-			// Find current slip angle
-			constexpr float RadToDegree = 180 / PI; // convert radians to degrees
-			const float ASin = FMath::Asin(FVector::DotProduct(RightOnPlane, LinearVelocityOnPlaneNormalized));
-			const float SlipAngle = -ASin * RadToDegree; // Slip angle in degrees
-
-			const float RollingAngVel = WheelVelocityLocal.X / WheelConfig.WheelRadius;
-			WheelState.AngularVelocity = RollingAngVel;
-			
-			// Find SlipX Target
-			float XSlipTarget = 0.0f;
-			if( (PhysicsInput->VehicleInputs.Handbrake && WheelConfig.IsHandbrakeWheel) || WheelConfig.isLocked ) // Wheel Locking
+		if( TraceWheel )
+		{
+			// Lower tiers always use one ray, the configured contact model is only worth its cost close to a player
+			const EWheelContactModel ContactModel = (PhysicsInput.SimulationTier == EVehicleSimulationTier::Full) ? WheelStore.ContactModels[WIndex] : EWheelContactModel::SingleRay;
+			const ECollisionChannel TraceChannel = WheelStore.TraceChannels[WIndex];
+			const FCollisionQueryParams* QueryParams = &WheelStore.QueryParams[WIndex];
+			if( ContactModel == EWheelContactModel::MultiRay )
 			{
-				WheelState.AngularVelocity = 0.0f;
-				XSlipTarget = FMath::Sign(-WheelVelocityLocalM.X);
+				const int32 NumRays = WheelStore.ContactRayCounts[WIndex];
+				WheelStore.QueryIndices[WIndex] = QueryBatch.AddProfileRays(TraceStart, TraceEnd, WheelWorldTransform.GetUnitAxis( EAxis::X ),
+					WheelStore.Radii[WIndex], WheelStore.ContactRaySpreads[WIndex], NumRays, TraceChannel, QueryParams);
+				WheelStore.QueryCounts[WIndex] = static_cast<uint8>(NumRays);
 			}
 			else
 			{
-				const float MaxFrictionTorque = SuspensionForceN * (WheelConfig.WheelRadius * 0.01f) * EffectiveFriction.X; // SpringForce(N) * Radius(M) * Friction
+				const float SweepRadius = (ContactModel == EWheelContactModel::SphereSweep) ? WheelStore.ContactSweepRadii[WIndex] : 0.0f;
+				WheelStore.QueryIndices[WIndex] = QueryBatch.AddRay(TraceStart, TraceEnd, TraceChannel, QueryParams, SweepRadius);
+				WheelStore.QueryCounts[WIndex] = 1;
+			}
+			WheelStore.LastTraceLocations[WIndex] = WheelWorldLocation;
+			WheelStore.LastTraceSteps[WIndex] = PhysicsStepCount;
+		}
+		else
+		{
+			WheelStore.QueryIndices[WIndex] = INDEX_NONE;
+			if( !Solved )
+			{
+				LastHit.SolveAgainstPlane(TraceStart, TraceEnd, WheelStore.SolvedHits[WIndex]);
+			}
+		}
+	}
+	return true;
+}
 
-				float BrakeInput = WheelConfig.IsBrakingWheel ? PhysicsInput->VehicleInputs.Brake : 0.0f; // Set BrakeInput as user input if braking wheel
-				BrakeInput = FMath::Clamp(BrakeInput, WheelConfig.RollingResistance, 1.0f); // Clamp between Resistance & 1, RollingResistance can just be applied as brakes
-				//float XBrakeTorque = (0.0f - RollingAngVel) / ChaosDelta * WheelConfig.Inertia; XBrakeTorque *= BrakeInput;
-				float XBrakeTorque = FMath::Sign(WheelState.AngularVelocity * (-1.0f)) * WheelConfig.BrakeTorque * BrakeInput;
+bool AVehicleSystemBase::AVS_HasDynamicObjectsNearWheels()
+{
+	// One box around every wheel's trace, oriented with the vehicle
+	FBox LocalBounds(ForceInit);
+	for( int32 WIndex = 0; WIndex < WheelStore.Num(); ++WIndex )
+	{
+		const float TraceHalfLength = WheelStore.SpringLengths[WIndex]*0.5f + WheelStore.Radii[WIndex];
+		LocalBounds += FBox::BuildAABB(WheelStore.LocalTransforms[WIndex].GetLocation(), FVector(WheelStore.Radii[WIndex], WheelStore.Radii[WIndex], TraceHalfLength));
+	}
+	if( !LocalBounds.IsValid || GetWorld() == nullptr )
+		return true;
+
+	// Everything the wheels could trace, whatever its object type. Only components that are not Static can be missing from the grid.
+	// Wheel trace params already ignore the vehicle and the wheels' ignore actors
+	const FVector Center = PhysicsBodyTransform.TransformPosition(LocalBounds.GetCenter());
+	const FCollisionShape Box = FCollisionShape::MakeBox(LocalBounds.GetExtent());
+	for( int32 WIndex = 0; WIndex < WheelStore.Num(); ++WIndex )
+	{
+		const ECollisionChannel TraceChannel = WheelStore.TraceChannels[WIndex];
+		if( WIndex > 0 && WheelStore.TraceChannels.Find(TraceChannel) < WIndex ) continue; // Channel already checked
 
-				float XDriveTorqueNm = 0.0f;
-				if( (PhysicsInput->VehicleInputs.Torque > 0.0f) && WheelConfig.IsDrivingWheel ) // Throttle
-				{
-					float InputTorque = PhysicsInput->VehicleInputs.Torque;
-					if(WheelConfig.InvertTorque ^ PhysicsInput->VehicleInputs.ReverseTorque) InputTorque *= -1.0f; // Invert torque if needed
-					float NewAngVel = WheelState.AngularVelocity + ((InputTorque*100.0f) / WheelConfig.Inertia * ChaosDelta);
+		NearWheelOverlaps.Reset();
+		GetWorld()->OverlapMultiByChannel(NearWheelOverlaps, Center, PhysicsBodyTransform.GetRotation(), TraceChannel, Box, WheelStore.QueryParams[WIndex]);
+		for( const FOverlapResult& Overlap : NearWheelOverlaps )
+		{
+			const UPrimitiveComponent* Component = Overlap.GetComponent();
+			if( Component != nullptr && Component->Mobility != EComponentMobility::Static )
+				return true;
+		}
+	}
+	return false;
+}
 
-					// Calculate the XSlip based on the new angular velocity
-					XDriveTorqueNm = (NewAngVel - RollingAngVel) / ChaosDelta * WheelConfig.Inertia;
-				}
+void AVehicleSystemBase::AVS_PhysicsTick(float ChaosDelta, float GravityZ, const FAVS_VehiclePhysicsInput& PhysicsInput,
+	FAVS_VehiclePhysicsOutput& PhysicsOutput, const FAVS_WheelQueryBatch& QueryBatch, FAVS_ForceAccumulator& Forces)
+{
+	using namespace Chaos;
+	
+	PhysicsOutput.WheelConfigVersion = WheelStore.ConfigVersion; // Tells the game thread it can stop sending configs
+	PhysicsOutput.WheelOutputs.SetNum(WheelStore.Num());
 
-				float XFinalTorque = XBrakeTorque + XDriveTorqueNm; // TODO :: Create debug logger and figure out why this doesn't work
-				XSlipTarget = XFinalTorque / MaxFrictionTorque;
+	WheelKernelData.Reset();
+	WheelContactData.Reset();
 
-				/*if( WIndex == 0 )
-				{
-					PhysicsOutput.DebugTexts.Add(DEBUG("Physics Thread: XBrakeTorque: %f", XBrakeTorque));
-					PhysicsOutput.DebugTexts.Add(DEBUG("Physics Thread: XDriveTorqueNm: %f", XDriveTorqueNm));
-					PhysicsOutput.DebugTexts.Add(DEBUG("Physics Thread: XFinalTorque: %f", XFinalTorque));
-					PhysicsOutput.DebugTexts.Add(DEBUG("Physics Thread: XSlipTarget: %f", XSlipTarget));
-				}*/
-			}
+	// ** Contacts ** //
 
-			// Interpolate SlipX to target
-			float SlipX = WheelState.Slip.X; // Long Slip
-			const float MinInterpSpeed = FMath::Clamp(PhysicsInput->VehicleInputs.Throttle * 0.1f, 0.01f, 0.1f);
-			const float InterpSpeedLong = FMath::Clamp(FMath::Abs(WheelVelocityLocalM.X) / 0.010f * ChaosDelta, MinInterpSpeed, 1.0f);
-			SlipX += (XSlipTarget - SlipX) * InterpSpeedLong;
-			SlipX = FMath::Clamp(SlipX, -30.0f, 30.0f); // Long Slip Limit
-			
-			// Find SlipY Target :: Simply Lerp from LowSpeedSlip -> HighSpeedSlip
-			const float YSlipTargetHighSpeed = SlipAngle / 12.0f; // SlipAngle / SlipAnglePeak
-			const float YSlipTargetLowSpeed = -FMath::Sign(WheelVelocityLocalM.Y);
-			const float Alpha = FMath::GetMappedRangeValueClamped(FVector2D(1.0f, 2.0f), FVector2D(0.0f, 1.0f), WheelVelocity);
-			const float YSlipTarget = FMath::Lerp(YSlipTargetLowSpeed, YSlipTargetHighSpeed, Alpha);
-			
-			// Interpolate SlipY to target
-			float SlipY = WheelState.Slip.Y; // Lat Slip
-            const float InterpSpeedLat = FMath::Clamp(FMath::Abs(WheelVelocityLocalM.Y) / 0.007f * ChaosDelta, 0.0f, 1.0f);
-            SlipY += (YSlipTarget - SlipY) * InterpSpeedLat;
-			
-			// Create final slip data
-            FVector2D Slip = FVector2D(SlipX, SlipY);
-			WheelState.Slip = Slip; // Save actual slip data before normalizing for final force
-			const float SlipLength = Slip.Size();
-            if (SlipLength > 1.0f) // Normalize
-            {
-                Slip.X /= SlipLength;
-                Slip.Y /= SlipLength;
-            }
-            Slip.Y = FMath::Sign(Slip.Y) * FMath::Sqrt(FMath::Abs(Slip.Y) ); // Square root the Lateral Force
-			
-			// Traction, the normalized slip defines how much we are using in each direction
-            const FVector TractionForward = ForwardOnPlane * Slip.X * EffectiveFriction.X;
-            const FVector TractionRight = RightOnPlane * Slip.Y * EffectiveFriction.Y;
-            FVector FrictionForceV = ((TractionForward + TractionRight) * SuspensionForceN)*100.0f; // *100.0f to convert to CentiNewtons
+	// Ends before the drivetrain, the contact loop is too long to wrap in a scope of its own
+	TOptional<FScopeCycleCounter> ContactsCycleCounter;
+	ContactsCycleCounter.Emplace(GET_STATID(STAT_AVS_Contacts));
+
+	// Loop through each wheel, airborne wheels are finished here and wheels with contact are queued for the force kernels
+	for( int32 WIndex = 0; WIndex < WheelStore.Num(); ++WIndex )
+	{
+		FAVS1_Wheel_Output& WheelOutput = PhysicsOutput.WheelOutputs[WIndex]; // Output for this wheel
 
-			// Apply Forces
-			FVector FinalWheelForce = SuspensionForceV + FrictionForceV;
-			UVehicleSystemFunctions::AVS_ChaosAddForceAtLocation(PhysicsInput->VehicleMeshPrim, WheelWorldLocation, FinalWheelForce);
-			AddDebugForce(PhysicsOutput, FDebugForce(WheelWorldLocation, FinalWheelForce, WheelConfig.WheelMode));
+		// Columns read by every path below, state is written straight back to the store
+		const float SpringLength = WheelStore.SpringLengths[WIndex];
+		const EWheelMode WheelMode = WheelStore.WheelModes[WIndex];
+		float& AngularVelocity = WheelStore.AngularVelocities[WIndex];
+
+		const FTransform& WheelWorldTransform = WheelStore.WorldTransforms[WIndex];
+		FVector WheelWorldLocation = WheelWorldTransform.GetLocation();
+		FVector WheelWorldForward = WheelWorldTransform.GetUnitAxis( EAxis::X );
+		FVector WheelWorldRight = WheelWorldTransform.GetUnitAxis( EAxis::Y );
+		FVector WheelWorldUp = WheelWorldTransform.GetUnitAxis( EAxis::Z );
+
+		// Result from the batched query stage, or solved against the last hit's plane for wheels not traced this step
+		const int32 QueryIndex = WheelStore.QueryIndices[WIndex];
+		const FAVS_WheelHit& Trace = (QueryIndex != INDEX_NONE) ? QueryBatch.GetClosestHit(QueryIndex, WheelStore.QueryCounts[WIndex]) : WheelStore.SolvedHits[WIndex];
+		if( QueryIndex != INDEX_NONE )
+		{
+			WheelStore.LastHits[WIndex] = Trace;
+			#if !UE_BUILD_SHIPPING && !UE_BUILD_TEST
+			for( int32 RIndex = QueryIndex; RIndex < QueryIndex + WheelStore.QueryCounts[WIndex]; ++RIndex )
+			{
+				AddDebugTrace(PhysicsOutput, QueryBatch.GetHit(RIndex).ToHitResult(QueryBatch.GetRay(RIndex)));
+			}
+			#endif
 		}
-		else // TraceHit
+
+		FAVS_WheelContact& OutputContact = WheelOutput.Contact;
+		OutputContact.HasContact = Trace.bBlockingHit;
+		OutputContact.SurfaceType = Trace.PhysMaterial.IsValid() ? Trace.PhysMaterial->SurfaceType.GetValue() : SurfaceType_Default;
+		OutputContact.Distance = Trace.Distance;
+		OutputContact.ImpactPoint = Trace.ImpactPoint;
+		OutputContact.ImpactNormal = Trace.ImpactNormal;
+		
+		if( !Trace.bBlockingHit )
 		{
-			WheelOutput.CurrentSpringLength = WheelConfig.SpringLength; // Used by game thread to place wheel mesh
-			WheelState.Slip = FVector2D::ZeroVector; // No slip while in air
+			WheelOutput.CurrentSpringLength = SpringLength; // Used by game thread to place wheel mesh
+			WheelStore.Slips[WIndex] = FVector2D::ZeroVector; // No slip while in air
 
-			if( (PhysicsInput->VehicleInputs.Handbrake && WheelConfig.IsHandbrakeWheel) // Handbrake
-				|| ((PhysicsInput->VehicleInputs.Brake > 0.0f) && WheelConfig.IsBrakingWheel) ) // Normal brake
+			if( (PhysicsInput.VehicleInputs.Handbrake && WheelStore.HasFlag(WIndex, FAVS_WheelStore::WF_Handbrake)) // Handbrake
+				|| ((PhysicsInput.VehicleInputs.Brake > 0.0f) && WheelStore.HasFlag(WIndex, FAVS_WheelStore::WF_Braking)) ) // Normal brake
 			{
-				WheelState.AngularVelocity = 0.0f;
+				AngularVelocity = 0.0f;
 			}
 
-			if( WheelConfig.WheelMode == EWheelMode::Physics )
+			if( WheelMode == EWheelMode::Physics )
 			{
-				FTransform PhysWheelTransform = UVehicleSystemFunctions::AVS_GetChaosTransform(WheelConfig.WheelPrim);
-				FVector SpringStart = WheelWorldLocation + WheelWorldUp * (WheelConfig.SpringLength * 0.5f);
+				UPrimitiveComponent* WheelPrim = WheelStore.WheelPrims[WIndex];
+				FTransform PhysWheelTransform = UVehicleSystemFunctions::AVS_GetChaosTransform(WheelPrim);
+				FVector SpringStart = WheelWorldLocation + WheelWorldUp * (SpringLength * 0.5f);
 
 				float NewSpringLength = FVector::Dist(SpringStart, PhysWheelTransform.GetLocation());
-				NewSpringLength = FMath::Clamp(NewSpringLength, 0.0f, WheelConfig.SpringLength);
+				NewSpringLength = FMath::Clamp(NewSpringLength, 0.0f, SpringLength);
 
-				if( NewSpringLength < WheelConfig.SpringLength )
+				if( NewSpringLength < SpringLength )
 				{
-					const float SpringStrengthNm = WheelConfig.SpringStrength * 1000.0f; // Spring Strength in N/m
-					const float CompressionDistanceM = (WheelConfig.SpringLength - NewSpringLength) * 0.01f; // Distance of compression in Meters
+					const float SpringStrengthNm = WheelStore.SpringStrengths[WIndex] * 1000.0f; // Spring Strength in N/m
+					const float CompressionDistanceM = (SpringLength - NewSpringLength) * 0.01f; // Distance of compression in Meters
 					float SpringForceN = SpringStrengthNm * CompressionDistanceM;
 					const float SuspensionForceN = SpringForceN;
 					FVector SuspensionForceV = (WheelWorldUp * SuspensionForceN) * 100.0f; // Final suspension force in CentiNewtons
 
 					// Apply Suspension Forces
-					UVehicleSystemFunctions::AVS_ChaosAddForceAtLocation(PhysicsInput->VehicleMeshPrim, PhysWheelTransform.GetLocation(), SuspensionForceV);
-					UVehicleSystemFunctions::AVS_ChaosAddForce(WheelConfig.WheelPrim, -SuspensionForceV, false);
-					AddDebugForce(PhysicsOutput, FDebugForce(PhysWheelTransform.GetLocation(), SuspensionForceV, WheelConfig.WheelMode));
+					Forces.AddForceAtLocation(PhysicsInput.VehicleMeshPrim, PhysWheelTransform.GetLocation(), SuspensionForceV);
+					Forces.AddForce(WheelPrim, -SuspensionForceV);
+					AddDebugForce(PhysicsOutput, FDebugForce(PhysWheelTransform.GetLocation(), SuspensionForceV, WheelMode));
 				}
 			}
+			WheelOutput.AngularVelocity = AngularVelocity;
+			continue;
+		}
+
+		// Wheel World and Contact Velocity
+		const FVector WheelVelocityWorld = UVehicleSystemFunctions::AVS_ChaosGetVelocityAtLocation(PhysicsInput.VehicleMeshPrim, Trace.ImpactPoint);
+		const FVector WheelVelocityLocal = WheelWorldTransform.Inverse().TransformVectorNoScale(WheelVelocityWorld);
+		//UPrimitiveComponent* ContactComponent = HitResult.GetComponent(); // Get the contact object //TODO :: Chaos Thread equivalent
+		const FVector ContactCompVelocityWorld = FVector::ZeroVector;//ContactComponent->GetPhysicsLinearVelocityAtPoint(ImpactPoint);
+		const FVector WheelVelocityWorldM = (WheelVelocityWorld - ContactCompVelocityWorld) * 0.01f; // Velocity relative to contacted object (Meters/Second)
+		const FVector WheelVelocityProjected = FVector::VectorPlaneProject(WheelVelocityWorldM, Trace.ImpactNormal); // Project speed onto plane
+
+		FWheelContactData& Contact = WheelContactData.AddDefaulted_GetRef();
+		Contact.WheelWorldLocation = WheelWorldLocation;
+		Contact.ImpactLocation = Trace.Location;
+		Contact.ImpactNormal = Trace.ImpactNormal;
+		Contact.WheelVelocityLocal = WheelVelocityLocal;
+		Contact.WheelVelocityLocalM = WheelWorldTransform.InverseTransformVectorNoScale(WheelVelocityProjected); // Wheel velocity relative to vehicle (Meters/Second)
+		Contact.SurfaceFriction = (Trace.PhysMaterial.IsValid()) ? Trace.PhysMaterial->Friction : 1.0f;
+
+		// Project the axes onto the plane
+		Contact.ForwardOnPlane = FVector::VectorPlaneProject(WheelWorldForward, Trace.ImpactNormal); Contact.ForwardOnPlane.Normalize();
+		Contact.RightOnPlane = FVector::VectorPlaneProject(WheelWorldRight, Trace.ImpactNormal); Contact.RightOnPlane.Normalize();
+		Contact.WheelVelocity = WheelVelocityProjected.Size(); // Wheel velocity in Meters/Second
+		FVector LinearVelocityOnPlaneNormalized; if (Contact.WheelVelocity != 0.0f) LinearVelocityOnPlaneNormalized = WheelVelocityProjected / Contact.WheelVelocity;
+
+		// Find current slip angle
+		constexpr float RadToDegree = 180 / PI; // convert radians to degrees
+		const float ASin = FMath::Asin(FVector::DotProduct(Contact.RightOnPlane, LinearVelocityOnPlaneNormalized));
+		Contact.SlipAngle = -ASin * RadToDegree; // Slip angle in degrees
+
+		// Suspension inputs
+		const int32 Lane = WheelKernelData.AddLane(WIndex);
+		WheelKernelData.TraceDistances[Lane] = Trace.Distance;
+		WheelKernelData.SpringLengths[Lane] = SpringLength;
+		WheelKernelData.Radii[Lane] = WheelStore.Radii[WIndex];
+		WheelKernelData.SpringStrengths[Lane] = WheelStore.SpringStrengths[WIndex];
+		WheelKernelData.SpringDampings[Lane] = WheelStore.SpringDampings[WIndex];
+		WheelKernelData.CompressionVelocities[Lane] = WheelVelocityLocal.Z * (-0.01f); // Velocity of compression in Meters/Second
+		WheelKernelData.ImpactTilts[Lane] = 1.0f - FMath::Abs(FVector::DotProduct(Trace.ImpactNormal, WheelWorldRight)); // 1.0f = Wheel is upright, 0.0f = Wheel is sideways (Relative to the Impact Normal)
+		WheelKernelData.TireTables[Lane] = (PhysicsInput.SimulationTier == EVehicleSimulationTier::Full) ? WheelStore.TireTables[WIndex].Get() : nullptr; // Lower tiers use the default friction curve
+	}
+
+	ContactsCycleCounter.Reset();
+
+	// ** Drivetrain ** //
+
+	const bool UseNativeDrivetrain = PhysicsInput.Drivetrain.IsValid();
+	if( UseNativeDrivetrain )
+	{
+		const FAVS_DrivetrainConfig& Drivetrain = *PhysicsInput.Drivetrain;
+		const Chaos::FRigidBodyHandle_Internal* BodyHandle = FAVS_ForceAccumulator::GetRigidHandle(PhysicsInput.VehicleMeshPrim);
+		const float ForwardSpeed = BodyHandle ? FVector::DotProduct(FVector(BodyHandle->V()), PhysicsBodyTransform.GetUnitAxis(EAxis::X)) : 0.0f;
+		const float EngineTorque = FAVS_Drivetrain::StepEngine(Drivetrain, DrivetrainState, ForwardSpeed, PhysicsInput.VehicleInputs.Throttle, ChaosDelta);
+
+		// Grip of every driving wheel from last step's slip, airborne wheels have none
+		WheelDriveTorques.Init(0.0f, WheelStore.Num());
+		DrivetrainGrips.Reset();
+		for( int32 WIndex = 0; WIndex < WheelStore.Num(); ++WIndex )
+		{
+			if( !WheelStore.HasFlag(WIndex, FAVS_WheelStore::WF_Driving) ) continue;
+			const bool HasContact = WheelKernelData.WheelIndices.Contains(WIndex);
+			DrivetrainGrips.Add(HasContact ? 1.0f / (1.0f + FMath::Abs(WheelStore.Slips[WIndex].X)) : 0.0f);
+		}
+		DrivetrainTorques.SetNumUninitialized(DrivetrainGrips.Num());
+		FAVS_Drivetrain::SplitTorque(Drivetrain, EngineTorque, DrivetrainGrips, DrivetrainTorques);
+		for( int32 WIndex = 0, Driven = 0; WIndex < WheelStore.Num(); ++WIndex )
+		{
+			if( WheelStore.HasFlag(WIndex, FAVS_WheelStore::WF_Driving) ) WheelDriveTorques[WIndex] = DrivetrainTorques[Driven++];
+		}
+
+		PhysicsOutput.Gear = Drivetrain.Gears.Num() > 0 ? DrivetrainState.Gear + 1 : 0;
+		PhysicsOutput.EngineRPM = DrivetrainState.EngineRPM;
+	}
+
+	const int32 NumContacts = WheelContactData.Num();
+	if( NumContacts == 0 ) return;
+	WheelKernelData.PadToGroupWidth();
+
+	// ** Suspension ** //
+
+	{
+		AVS_SCOPE_CYCLE_COUNTER(Suspension);
+		const float AntiGravityN = (-GravityZ * PhysicsInput.VehicleMass) * 0.01f; // Added while the spring is over compressed
+		FAVS_WheelKernel::Suspension(WheelKernelData, AntiGravityN);
+	}
+
+	// ** Slip ** //
+
+	AVS_SCOPE_CYCLE_COUNTER(Friction); // Slip, traction and the wheel forces, until the end of the step
+
+	for( int32 Lane = 0; Lane < NumContacts; ++Lane )
+	{
+		const int32 WIndex = WheelKernelData.WheelIndices[Lane];
+		const FWheelContactData& Contact = WheelContactData[Lane];
+		FAVS1_Wheel_Output& WheelOutput = PhysicsOutput.WheelOutputs[WIndex];
+		const EWheelMode WheelMode = WheelStore.WheelModes[WIndex];
+		float& AngularVelocity = WheelStore.AngularVelocities[WIndex];
+
+		WheelOutput.CurrentSpringLength = WheelKernelData.CurrentSpringLengths[Lane]; // Used by game thread to place wheel mesh
+		const float SuspensionForceN = WheelKernelData.SuspensionForces[Lane];
+
+		if( WheelMode == EWheelMode::Physics )
+		{
+			UPrimitiveComponent* WheelPrim = WheelStore.WheelPrims[WIndex];
+			const FVector SuspensionForceV = (Contact.ImpactNormal * SuspensionForceN) * 100.0f; // Final suspension force in CentiNewtons
+
+			// Apply Suspension Forces
+			Forces.AddForceAtLocation(PhysicsInput.VehicleMeshPrim, Contact.ImpactLocation, SuspensionForceV);
+			Forces.AddForce(WheelPrim, -SuspensionForceV);
+			AddDebugForce(PhysicsOutput, FDebugForce(Contact.ImpactLocation, SuspensionForceV, WheelMode));
+
+			if( WheelStore.HasFlag(WIndex, FAVS_WheelStore::WF_Braking) )
+			{
+				// Apply Brake Torque
+				float BrakeInput = PhysicsInput.VehicleInputs.Brake; // Set BrakeInput as user input if braking wheel
+				//BrakeInput = FMath::Clamp((BrakeInput * BrakePressure), WheelStore.RollingResistances[WIndex] * 0.1f, 1.0f); // Clamp between Resistance & 1, RollingResistance can just be applied as brakes
+				if( BrakeInput > 0.0f ) Forces.AddBrakeTorque(WheelPrim, WheelStore.BrakeTorques[WIndex] * BrakeInput, ChaosDelta); // TODO: Get physics brake torque to properly accept Nm
+				// TODO Physics rolling resistance
+			}
+			
+			continue; // Finish this wheel here, the physics engine handles friction and torque
 		}
-		WheelOutput.AngularVelocity = WheelState.AngularVelocity;
-		PhysicsOutput.WheelOutputs.Add(WheelOutput);
+
+		// Slip, drive and brake torque are handled by the dynamics core
+		FAVS_WheelSlipInput SlipInput;
+		SlipInput.DeltaTime = ChaosDelta;
+		SlipInput.SuspensionForceN = SuspensionForceN;
+		SlipInput.WheelRadius = WheelStore.Radii[WIndex];
+		SlipInput.Inertia = WheelStore.Inertias[WIndex];
+		SlipInput.BrakeTorque = WheelStore.BrakeTorques[WIndex];
+		SlipInput.RollingResistance = WheelStore.RollingResistances[WIndex];
+		SlipInput.Friction = WheelStore.TireFrictions[WIndex] * Contact.SurfaceFriction; // Friction combine method = Multiply
+		SlipInput.RollingVelocity = Contact.WheelVelocityLocal.X;
+		SlipInput.ContactVelocityM = FVector2D(Contact.WheelVelocityLocalM.X, Contact.WheelVelocityLocalM.Y);
+		SlipInput.ContactSpeedM = Contact.WheelVelocity;
+		SlipInput.SlipAngle = Contact.SlipAngle;
+		SlipInput.Throttle = PhysicsInput.VehicleInputs.Throttle;
+		SlipInput.Brake = WheelStore.HasFlag(WIndex, FAVS_WheelStore::WF_Braking) ? PhysicsInput.VehicleInputs.Brake : 0.0f;
+		SlipInput.Locked = (PhysicsInput.VehicleInputs.Handbrake && WheelStore.HasFlag(WIndex, FAVS_WheelStore::WF_Handbrake)) || WheelStore.HasFlag(WIndex, FAVS_WheelStore::WF_Locked);
+		const float WheelDriveTorque = UseNativeDrivetrain ? WheelDriveTorques[WIndex] : PhysicsInput.VehicleInputs.Torque;
+		if( (WheelDriveTorque > 0.0f) && WheelStore.HasFlag(WIndex, FAVS_WheelStore::WF_Driving) ) // Throttle
+		{
+			SlipInput.DriveTorque = WheelDriveTorque;
+			if(WheelStore.HasFlag(WIndex, FAVS_WheelStore::WF_InvertTorque) ^ PhysicsInput.VehicleInputs.ReverseTorque) SlipInput.DriveTorque *= -1.0f; // Invert torque if needed
+		}
+
+		// Same trace for every substep, traction uses the average slip so the chassis gets one force
+		const bool FullTier = PhysicsInput.SimulationTier == EVehicleSimulationTier::Full;
+		SlipInput.SnapSlip = !FullTier;
+		FVector2D AverageSlip;
+		FAVS_DynamicsCore::StepSlipSubsteps(SlipInput, FullTier ? WheelStore.SlipSubsteps[WIndex] : 1, WheelStore.Slips[WIndex], AngularVelocity, AverageSlip);
+
+		WheelKernelData.SlipsX[Lane] = AverageSlip.X;
+		WheelKernelData.SlipsY[Lane] = AverageSlip.Y;
+		WheelKernelData.FrictionsX[Lane] = SlipInput.Friction.X;
+		WheelKernelData.FrictionsY[Lane] = SlipInput.Friction.Y;
+		WheelOutput.AngularVelocity = AngularVelocity;
+	}
+
+	// ** Traction ** //
+
+	FAVS_WheelKernel::Traction(WheelKernelData);
+
+	for( int32 Lane = 0; Lane < NumContacts; ++Lane )
+	{
+		const int32 WIndex = WheelKernelData.WheelIndices[Lane];
+		const EWheelMode WheelMode = WheelStore.WheelModes[WIndex];
+		if( WheelMode == EWheelMode::Physics ) continue; // Already applied
+
+		const FWheelContactData& Contact = WheelContactData[Lane];
+		const float SuspensionForceN = WheelKernelData.SuspensionForces[Lane];
+		const FVector SuspensionForceV = (Contact.ImpactNormal * SuspensionForceN) * 100.0f; // Final suspension force in CentiNewtons
+
+		// Traction, the normalized slip defines how much we are using in each direction
+		const FVector TractionForward = Contact.ForwardOnPlane * WheelKernelData.TractionsX[Lane];
+		const FVector TractionRight = Contact.RightOnPlane * WheelKernelData.TractionsY[Lane];
+		FVector FrictionForceV = ((TractionForward + TractionRight) * SuspensionForceN)*100.0f; // *100.0f to convert to CentiNewtons
+
+		// Apply Forces
+		FVector FinalWheelForce = SuspensionForceV + FrictionForceV;
+		Forces.AddForceAtLocation(PhysicsInput.VehicleMeshPrim, Contact.WheelWorldLocation, FinalWheelForce);
+		AddDebugForce(PhysicsOutput, FDebugForce(Contact.WheelWorldLocation, FinalWheelForce, WheelMode));
 	}
 }
 
@@ -877,8 +1549,6 @@ bool AVehicleSystemBase::SetArrayDisabledCollisions(TArray<UPrimitiveComponent*>
 	
 	if(IsPhysicsCallbackRegistered())
 	{
-		TArray<FSingleParticlePhysicsProxy*> ChaosHandles;
-		ChaosHandles.Empty();
 		for(UPrimitiveComponent* Mesh : Meshes)
 		{
 			FBodyInstance* BI = Mesh->GetBodyInstance();
@@ -888,25 +1558,42 @@ bool AVehicleSystemBase::SetArrayDisabledCollisions(TArray<UPrimitiveComponent*>
 			FSingleParticlePhysicsProxy* MeshHandle = BI->GetPhysicsActorHandle();
 			if(!MeshHandle)
 				return false; // Handle is not valid, failed
-			
-			ChaosHandles.Add(MeshHandle);
-			BI->SetContactModification(true);
 		}
+
 		for(UPrimitiveComponent* OldMesh : ContactModMeshes)
 		{
-			// Turn contact mod off on meshes no longer in the array
-			if(!Meshes.Contains(OldMesh))
-			{
-				FBodyInstance* OldBI = OldMesh->GetBodyInstance();
-				if(OldBI)
-				{
-					OldBI->SetContactModification(false);
-				}
-			}
+			if(IsValid(OldMesh) && !Meshes.Contains(OldMesh))
+				OldMesh->OnComponentPhysicsStateChanged.RemoveDynamic(this, &AVehicleSystemBase::OnDisabledMeshPhysicsStateChanged);
+		}
+		for(UPrimitiveComponent* Mesh : Meshes)
+		{
+			Mesh->OnComponentPhysicsStateChanged.AddUniqueDynamic(this, &AVehicleSystemBase::OnDisabledMeshPhysicsStateChanged);
 		}
+
 		ContactModMeshes = Meshes; // Save the new array
-		PhysicsThreadCallback->WheelMeshes = ChaosHandles; // Overwrite array, not add, we don't want invalid handles
+		SendDisabledCollisions(); // Overwrite array, not add, pairs of meshes no longer in it are removed
 		return true; // Success
 	}
 	return false; // Callback is not valid, failed
 }
+
+void AVehicleSystemBase::OnDisabledMeshPhysicsStateChanged(UPrimitiveComponent* ChangedComponent, EComponentPhysicsStateChange StateChange)
+{
+	if( !IsPhysicsCallbackRegistered() || !ContactModMeshes.Contains(ChangedComponent) )
+		return;
+
+	// A destroyed body drops out until it is created again, its pairs are removed by index on the physics thread
+	SendDisabledCollisions(StateChange == EComponentPhysicsStateChange::Destroyed ? ChangedComponent : nullptr);
+}
+
+void AVehicleSystemBase::SendDisabledCollisions(const UPrimitiveComponent* SkipMesh)
+{
+	TArray<Chaos::FSingleParticlePhysicsProxy*> ChaosHandles;
+	for( UPrimitiveComponent* Mesh : ContactModMeshes )
+	{
+		FBodyInstance* BI = (IsValid(Mesh) && Mesh != SkipMesh) ? Mesh->GetBodyInstance() : nullptr;
+		if( BI && BI->GetPhysicsActorHandle() )
+			ChaosHandles.Add(BI->GetPhysicsActorHandle());
+	}
+	PhysicsSubsystem->SetDisabledCollisions(VehicleMesh->GetBodyInstance()->GetPhysicsActorHandle(), ChaosHandles);
+}
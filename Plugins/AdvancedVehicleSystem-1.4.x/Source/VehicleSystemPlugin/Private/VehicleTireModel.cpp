@@ -0,0 +1,88 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehicleTireModel.h"
+
+namespace
+{
+	float MagicFormula(float Slip, float B, float C, float D, float E)
+	{
+		const float BX = B * Slip;
+		return D * FMath::Sin(C * FMath::Atan(BX - E * (BX - FMath::Atan(BX))));
+	}
+
+	// Raw slip of the curve's peak, found by sampling since E moves it
+	float FindPeakSlip(float B, float C, float E)
+	{
+		constexpr int32 NumSamples = 2000;
+		const float MaxSlip = 20.0f / B;
+		float PeakSlip = MaxSlip;
+		float PeakForce = 0.0f;
+		for( int32 Sample = 1; Sample <= NumSamples; ++Sample )
+		{
+			const float Slip = MaxSlip * Sample / NumSamples;
+			const float Force = MagicFormula(Slip, B, C, 1.0f, E);
+			if( Force > PeakForce )
+			{
+				PeakForce = Force;
+				PeakSlip = Slip;
+			}
+		}
+		return PeakSlip;
+	}
+}
+
+void UVehicleTireModel::PostInitProperties()
+{
+	Super::PostInitProperties();
+	BakeTable(); // Assets created at runtime never get PostLoad
+}
+
+void UVehicleTireModel::PostLoad()
+{
+	Super::PostLoad();
+	BakeTable();
+}
+
+#if WITH_EDITOR
+void UVehicleTireModel::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	BakeTable(); // Wheels already simulating keep the old table until their config is resent
+}
+#endif
+
+void UVehicleTireModel::BakeTable()
+{
+	TSharedPtr<FAVS_TireTable, ESPMode::ThreadSafe> NewTable = MakeShared<FAVS_TireTable, ESPMode::ThreadSafe>();
+	NewTable->Resolution = FMath::Clamp(TableResolution, 9, 129);
+	NewTable->SlipRange = FMath::Max(SlipRange, 1.0f);
+	NewTable->InvStep = (NewTable->Resolution - 1) / (2.0f * NewTable->SlipRange);
+
+	const float LongPeakSlip = FindPeakSlip(LongStiffness, LongShape, LongCurvature);
+	const float LatPeakSlip = FindPeakSlip(LatStiffness, LatShape, LatCurvature);
+
+	// Combined slip: both axes use the slip magnitude so force follows the friction ellipse, the direction comes from the slip
+	NewTable->Forces.SetNumUninitialized(NewTable->Resolution * NewTable->Resolution);
+	const float Step = 1.0f / NewTable->InvStep;
+	for( int32 Row = 0; Row < NewTable->Resolution; ++Row )
+	{
+		const float SlipY = Row * Step - NewTable->SlipRange;
+		for( int32 Column = 0; Column < NewTable->Resolution; ++Column )
+		{
+			const float SlipX = Column * Step - NewTable->SlipRange;
+			const float SlipLength = FMath::Sqrt(SlipX * SlipX + SlipY * SlipY);
+
+			FVector2f& Force = NewTable->Forces[Row * NewTable->Resolution + Column];
+			if( SlipLength < UE_KINDA_SMALL_NUMBER )
+			{
+				Force = FVector2f::ZeroVector;
+				continue;
+			}
+			Force.X = (SlipX / SlipLength) * MagicFormula(SlipLength * LongPeakSlip, LongStiffness, LongShape, LongPeak, LongCurvature);
+			Force.Y = (SlipY / SlipLength) * MagicFormula(SlipLength * LatPeakSlip, LatStiffness, LatShape, LatPeak, LatCurvature);
+		}
+	}
+
+	Table = NewTable;
+}
@@ -5,23 +5,29 @@
 
 #include "AVS_DEBUG.h"
 #include "VehicleSystemFunctions.h"
+#include "VehicleWheelQuery.h"
 #include "Components/SphereComponent.h"
-#include "Kismet/KismetMathLibrary.h"
 #include "VehicleSystemPlugin/VehicleSystemPlugin.h"
 
 UVehicleWheelBase::UVehicleWheelBase(): WheelStaticMesh(nullptr), WheelMeshComponent(nullptr)
 {
+	// Wheel visuals are updated by the vehicle, the tick is only enabled for Blueprint ReceiveTick
 	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 }
 
 void UVehicleWheelBase::BeginPlay()
 {
 	Super::BeginPlay();
 
+	HasBlueprintTick = GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UVehicleWheelBase, ReceiveTick));
+	SetComponentTickEnabled(HasBlueprintTick && !PassiveMode);
+
 	// Initialize wheel config
 	UpdateLocalTransformCache();
 	WheelConfig.CalculateConstants();
 	UpdateWheelRadius();
+	MarkWheelConfigDirty();
 }
 
 void UVehicleWheelBase::UpdateWheelRadius()
@@ -35,6 +41,7 @@ void UVehicleWheelBase::UpdateWheelRadius()
 		
 		WheelConfig.WheelRadius = UVehicleSystemFunctions::GetMeshRadius(WheelMeshComponent);
 		if( WheelConfig.WheelRadius <= 0.0f ) WheelConfig.WheelRadius = 30.0f;
+		MarkWheelConfigDirty();
 	}
 }
 
@@ -45,20 +52,31 @@ void UVehicleWheelBase::UpdateLocalTransformCache()
 		return;
 	
 	WheelConfig.WheelLocalTransform = GetComponentTransform().GetRelativeTransform(VehicleMesh->GetBodyInstance()->GetUnrealWorldTransform());
+	MarkWheelConfigDirty();
 }
 
-void UVehicleWheelBase::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UVehicleWheelBase::DetectWheelConfigChange()
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	if( LastWheelConfigVersion == WheelConfigVersion )
+	{
+		if( FAVS1_Wheel_Config::StaticStruct()->CompareScriptStruct(&WheelConfig, &LastWheelConfig, PPF_None) )
+			return;
+
+		WheelConfig.CalculateConstants(); // Mass or radius may have changed
+		MarkWheelConfigDirty();
+	}
+	LastWheelConfig = WheelConfig;
+	LastWheelConfigVersion = WheelConfigVersion;
+}
 
+void UVehicleWheelBase::UpdateVisuals(float DeltaTime)
+{
 	if( WheelConfig.WheelMode != EWheelMode::Raycast )
 		return;
 
 	if( !IsValid(WheelMeshComponent) || !GetIsAttached() || !GetIsSimulatingSuspension() )
 		return;
 
-	WheelConfig.isLocked = isLocked; // Copy isLocked into wheel config every frame, TODO not ideal should be changed later
-
 	if( GetHasContact() && !PassiveMode )
 	{
 		CurAngVel = WheelData.AngularVelocity;
@@ -84,20 +102,24 @@ void UVehicleWheelBase::TickComponent(float DeltaTime, ELevelTick TickType, FAct
 		}
 	}
 	
-	constexpr float RadsToDegreesPerSecond = (180.0f / PI);
 	const float SpringStart = WheelConfig.SpringLength*0.5f;
 	
-	// Add delta rotation
-	WheelRotation = UKismetMathLibrary::ComposeRotators(WheelRotation, FRotator(CurAngVel * RadsToDegreesPerSecond * -1.0f * DeltaTime, 0.0f, 0.0f));
+	// Spin around the axle then steer around up, same as composing the pitch and yaw rotators
+	WheelSpinAngle = FMath::UnwindRadians(WheelSpinAngle + CurAngVel * DeltaTime);
+	const FQuat SpinRot(FVector::YAxisVector, WheelSpinAngle);
+	const FQuat SteerRot(FVector::ZAxisVector, FMath::DegreesToRadians(GetSteeringAngle()));
 	
-	FVector NewLoc = FVector(0,0, FMath::Min(SpringStart + (WheelData.CurrentSpringLength * -1.0f), SpringStart) );
-	FRotator NewRot = UKismetMathLibrary::ComposeRotators(WheelRotation, FRotator(0.0f, GetSteeringAngle(), 0.0f));
-	WheelMeshComponent->SetRelativeLocationAndRotation(NewLoc, NewRot);
+	const FVector NewLoc = FVector(0,0, FMath::Min(SpringStart + (WheelData.CurrentSpringLength * -1.0f), SpringStart) );
+	const FQuat NewRot = SteerRot * SpinRot;
 
-	if( PassiveMode && FMath::Abs(CurAngVel) <= 0.01f )
-	{
-		SetComponentTickEnabled(false);
-	}
+	// Resting wheels keep their transform, skips the transform propagation and bounds update
+	if( HasVisualTransform && NewLoc.Equals(LastVisualLocation, 0.01f) && NewRot.Equals(LastVisualRotation, 1.e-5f) )
+		return;
+
+	WheelMeshComponent->SetRelativeLocationAndRotation(NewLoc, NewRot);
+	LastVisualLocation = NewLoc;
+	LastVisualRotation = NewRot;
+	HasVisualTransform = true;
 }
 
 void UVehicleWheelBase::SetWheelMode_Implementation(EWheelMode NewMode)
@@ -106,6 +128,7 @@ void UVehicleWheelBase::SetWheelMode_Implementation(EWheelMode NewMode)
 		return;
 	
 	WheelConfig.WheelMode = NewMode;
+	MarkWheelConfigDirty();
 	ResetWheelCollisions();
 }
 
@@ -123,6 +146,31 @@ void UVehicleWheelBase::ResetWheelCollisions()
 	}
 }
 
+FHitResult UVehicleWheelBase::GetLastTrace()
+{
+	if( CachedLastTraceFrame == GFrameCounter )
+		return CachedLastTrace;
+	CachedLastTraceFrame = GFrameCounter;
+
+	const FAVS_WheelContact& Contact = WheelData.Contact;
+	const FVector Start = Contact.ImpactPoint + Contact.ImpactNormal * 5.0f;
+	const FVector End = Contact.ImpactPoint - Contact.ImpactNormal * 5.0f;
+	CachedLastTrace = FHitResult(Start, End);
+
+	// Short trace through the contact point, only the details the physics thread did not send back are taken from it
+	UWorld* World = GetWorld();
+	if( Contact.HasContact && World )
+	{
+		const FCollisionQueryParams Params = FAVS_WheelQueryBatch::MakeQueryParams(GetOwner(), WheelConfig.TraceIgnoreActors);
+		World->LineTraceSingleByChannel(CachedLastTrace, Start, End, WheelConfig.TraceChannel, Params);
+		CachedLastTrace.bBlockingHit = true;
+		CachedLastTrace.Distance = Contact.Distance;
+		CachedLastTrace.ImpactPoint = Contact.ImpactPoint;
+		CachedLastTrace.ImpactNormal = Contact.ImpactNormal;
+	}
+	return CachedLastTrace;
+}
+
 float UVehicleWheelBase::GetWheelAngVelInRadians()
 {
 	if(GetWheelMode() == EWheelMode::Physics)
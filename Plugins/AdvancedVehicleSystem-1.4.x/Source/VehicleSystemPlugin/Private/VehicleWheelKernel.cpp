@@ -0,0 +1,283 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehicleWheelKernel.h"
+
+#include "AVS_DEBUG.h"
+#include "VehicleTireModel.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/VectorRegister.h"
+
+static TAutoConsoleVariable<int32> CVarAVSWheelKernel(
+	TEXT("avs.WheelKernel"),
+	1,
+	TEXT("Wheel force kernel. 0: scalar, 1: vector"),
+	ECVF_Default);
+
+#if !UE_BUILD_SHIPPING
+static TAutoConsoleVariable<int32> CVarAVSWheelKernelValidate(
+	TEXT("avs.WheelKernelValidate"),
+	0,
+	TEXT("Runs the scalar and vector wheel kernels side by side and logs lanes that do not match"),
+	ECVF_Cheat);
+
+namespace
+{
+	// Lanes in SkipLanes are not compared, they are left to the tire tables
+	void CompareKernelColumn(const TCHAR* Kernel, const TCHAR* Column, const TArray<float>& Scalar, const TArray<float>& Vector,
+		const TArray<const FAVS_TireTable*>* SkipLanes = nullptr)
+	{
+		for( int32 Lane = 0; Lane < Scalar.Num(); ++Lane )
+		{
+			if( SkipLanes != nullptr && (*SkipLanes)[Lane] != nullptr ) continue;
+			if( !FAVS_WheelKernel::ValuesMatch(Scalar[Lane], Vector[Lane]) )
+			{
+				UE_LOG(LogAVS, Warning, TEXT("%s kernel mismatch in %s, lane %d: scalar %f, vector %f"), Kernel, Column, Lane, Scalar[Lane], Vector[Lane]);
+			}
+		}
+	}
+}
+#endif
+
+bool FAVS_WheelKernel::ValuesMatch(float Scalar, float Vector)
+{
+	constexpr float RelativeTolerance = 1.e-4f; // The vector path multiplies by reciprocals where the scalar path divides
+	return FMath::Abs(Scalar - Vector) <= RelativeTolerance * FMath::Max(1.0f, FMath::Abs(Scalar));
+}
+
+void FAVS_WheelKernelData::Reset()
+{
+	TraceDistances.Reset();
+	SpringLengths.Reset();
+	Radii.Reset();
+	SpringStrengths.Reset();
+	SpringDampings.Reset();
+	CompressionVelocities.Reset();
+	ImpactTilts.Reset();
+	CurrentSpringLengths.Reset();
+	SuspensionForces.Reset();
+	SlipsX.Reset();
+	SlipsY.Reset();
+	FrictionsX.Reset();
+	FrictionsY.Reset();
+	TireTables.Reset();
+	TractionsX.Reset();
+	TractionsY.Reset();
+	WheelIndices.Reset();
+}
+
+int32 FAVS_WheelKernelData::AddLane(int32 WheelIndex)
+{
+	TraceDistances.Add(0.0f);
+	SpringLengths.Add(0.0f);
+	Radii.Add(0.0f);
+	SpringStrengths.Add(0.0f);
+	SpringDampings.Add(0.0f);
+	CompressionVelocities.Add(0.0f);
+	ImpactTilts.Add(0.0f);
+	CurrentSpringLengths.Add(0.0f);
+	SuspensionForces.Add(0.0f);
+	SlipsX.Add(0.0f);
+	SlipsY.Add(0.0f);
+	FrictionsX.Add(0.0f);
+	FrictionsY.Add(0.0f);
+	TireTables.Add(nullptr);
+	TractionsX.Add(0.0f);
+	TractionsY.Add(0.0f);
+	return WheelIndices.Add(WheelIndex);
+}
+
+void FAVS_WheelKernelData::PadToGroupWidth()
+{
+	// Zeroed lanes produce zero force in both kernels
+	while( Num() % GroupWidth != 0 )
+	{
+		AddLane(INDEX_NONE);
+	}
+}
+
+void FAVS_WheelKernel::Suspension(FAVS_WheelKernelData& Data, float AntiGravityN)
+{
+#if !UE_BUILD_SHIPPING
+	if( CVarAVSWheelKernelValidate.GetValueOnAnyThread() != 0 )
+	{
+		FAVS_WheelKernelData ScalarData = Data;
+		SuspensionScalar(ScalarData, AntiGravityN);
+		SuspensionVector(Data, AntiGravityN);
+		CompareKernelColumn(TEXT("Suspension"), TEXT("CurrentSpringLengths"), ScalarData.CurrentSpringLengths, Data.CurrentSpringLengths);
+		CompareKernelColumn(TEXT("Suspension"), TEXT("SuspensionForces"), ScalarData.SuspensionForces, Data.SuspensionForces);
+		return;
+	}
+#endif
+
+	if( CVarAVSWheelKernel.GetValueOnAnyThread() != 0 )
+	{
+		SuspensionVector(Data, AntiGravityN);
+	}
+	else
+	{
+		SuspensionScalar(Data, AntiGravityN);
+	}
+}
+
+void FAVS_WheelKernel::SuspensionScalar(FAVS_WheelKernelData& Data, float AntiGravityN)
+{
+	for( int32 Lane = 0; Lane < Data.Num(); ++Lane )
+	{
+		// Length of spring right now while compressed
+		const float SpringLength = Data.SpringLengths[Lane];
+		const float Length = Data.TraceDistances[Lane] - (Data.Radii[Lane] * 2.0f);
+		const float NewSpringLength = FMath::Clamp(Length, 0.0f, SpringLength);
+
+		const float SpringStrengthNm = Data.SpringStrengths[Lane] * 1000.0f; // Spring Strength in N/m
+		const float ShockAbsorption = Data.SpringDampings[Lane] * 1000.0f; // Spring Damper in Ns/m
+		const float CompressionDistanceM = (SpringLength - NewSpringLength) * 0.01f; // Distance of compression in Meters
+
+		float SpringForceN = SpringStrengthNm * CompressionDistanceM;
+		float DamperForceN = ShockAbsorption * Data.CompressionVelocities[Lane];
+
+		// Excess compression
+		if( Length < -1.0f )
+		{
+			SpringForceN += AntiGravityN;
+			DamperForceN *= 2;
+		}
+
+		// Scale applied force by wheel's left/right tilt to prevent sudden thrusts when landing sideways
+		const float TiltFalloff = FMath::Clamp((Data.ImpactTilts[Lane] - TiltFalloffEnd) / (TiltFalloffStart - TiltFalloffEnd), 0.0f, 1.0f);
+
+		Data.CurrentSpringLengths[Lane] = NewSpringLength;
+		Data.SuspensionForces[Lane] = (SpringForceN + DamperForceN) * TiltFalloff;
+	}
+}
+
+void FAVS_WheelKernel::SuspensionVector(FAVS_WheelKernelData& Data, float AntiGravityN)
+{
+	check(Data.Num() % FAVS_WheelKernelData::GroupWidth == 0);
+
+	const VectorRegister4Float Zero = GlobalVectorConstants::FloatZero;
+	const VectorRegister4Float One = GlobalVectorConstants::FloatOne;
+	const VectorRegister4Float Two = VectorSetFloat1(2.0f);
+	const VectorRegister4Float Thousand = VectorSetFloat1(1000.0f);
+	const VectorRegister4Float CmToM = VectorSetFloat1(0.01f);
+	const VectorRegister4Float ExcessLimit = VectorSetFloat1(-1.0f);
+	const VectorRegister4Float AntiGravity = VectorSetFloat1(AntiGravityN);
+	const VectorRegister4Float TiltEnd = VectorSetFloat1(TiltFalloffEnd);
+	const VectorRegister4Float TiltRangeInv = VectorSetFloat1(1.0f / (TiltFalloffStart - TiltFalloffEnd));
+
+	for( int32 Lane = 0; Lane < Data.Num(); Lane += FAVS_WheelKernelData::GroupWidth )
+	{
+		const VectorRegister4Float SpringLength = VectorLoad(&Data.SpringLengths[Lane]);
+		const VectorRegister4Float Length = VectorSubtract(VectorLoad(&Data.TraceDistances[Lane]), VectorMultiply(VectorLoad(&Data.Radii[Lane]), Two));
+		const VectorRegister4Float NewSpringLength = VectorMin(VectorMax(Length, Zero), SpringLength);
+
+		const VectorRegister4Float SpringStrengthNm = VectorMultiply(VectorLoad(&Data.SpringStrengths[Lane]), Thousand);
+		const VectorRegister4Float ShockAbsorption = VectorMultiply(VectorLoad(&Data.SpringDampings[Lane]), Thousand);
+		const VectorRegister4Float CompressionDistanceM = VectorMultiply(VectorSubtract(SpringLength, NewSpringLength), CmToM);
+
+		VectorRegister4Float SpringForceN = VectorMultiply(SpringStrengthNm, CompressionDistanceM);
+		VectorRegister4Float DamperForceN = VectorMultiply(ShockAbsorption, VectorLoad(&Data.CompressionVelocities[Lane]));
+
+		// Excess compression, branchless
+		const VectorRegister4Float Excess = VectorCompareLT(Length, ExcessLimit);
+		SpringForceN = VectorSelect(Excess, VectorAdd(SpringForceN, AntiGravity), SpringForceN);
+		DamperForceN = VectorSelect(Excess, VectorMultiply(DamperForceN, Two), DamperForceN);
+
+		const VectorRegister4Float TiltFalloff = VectorMin(VectorMax(VectorMultiply(VectorSubtract(VectorLoad(&Data.ImpactTilts[Lane]), TiltEnd), TiltRangeInv), Zero), One);
+
+		VectorStore(NewSpringLength, &Data.CurrentSpringLengths[Lane]);
+		VectorStore(VectorMultiply(VectorAdd(SpringForceN, DamperForceN), TiltFalloff), &Data.SuspensionForces[Lane]);
+	}
+}
+
+void FAVS_WheelKernel::Traction(FAVS_WheelKernelData& Data)
+{
+#if !UE_BUILD_SHIPPING
+	if( CVarAVSWheelKernelValidate.GetValueOnAnyThread() != 0 )
+	{
+		FAVS_WheelKernelData ScalarData = Data;
+		TractionScalar(ScalarData);
+		TractionVector(Data);
+		CompareKernelColumn(TEXT("Traction"), TEXT("TractionsX"), ScalarData.TractionsX, Data.TractionsX, &Data.TireTables);
+		CompareKernelColumn(TEXT("Traction"), TEXT("TractionsY"), ScalarData.TractionsY, Data.TractionsY, &Data.TireTables);
+		TractionTables(Data);
+		return;
+	}
+#endif
+
+	if( CVarAVSWheelKernel.GetValueOnAnyThread() != 0 )
+	{
+		TractionVector(Data);
+	}
+	else
+	{
+		TractionScalar(Data);
+	}
+	TractionTables(Data);
+}
+
+void FAVS_WheelKernel::TractionTables(FAVS_WheelKernelData& Data)
+{
+	for( int32 Lane = 0; Lane < Data.Num(); ++Lane )
+	{
+		const FAVS_TireTable* Table = Data.TireTables[Lane];
+		if( Table == nullptr ) continue;
+
+		const FVector2f Traction = Table->Evaluate(Data.SlipsX[Lane], Data.SlipsY[Lane]);
+		Data.TractionsX[Lane] = Traction.X * Data.FrictionsX[Lane];
+		Data.TractionsY[Lane] = Traction.Y * Data.FrictionsY[Lane];
+	}
+}
+
+void FAVS_WheelKernel::TractionScalar(FAVS_WheelKernelData& Data)
+{
+	for( int32 Lane = 0; Lane < Data.Num(); ++Lane )
+	{
+		if( Data.TireTables[Lane] != nullptr ) continue; // Filled by TractionTables
+
+		FVector2D Slip = FVector2D(Data.SlipsX[Lane], Data.SlipsY[Lane]);
+		const float SlipLength = Slip.Size();
+		if (SlipLength > 1.0f) // Normalize
+		{
+			Slip.X /= SlipLength;
+			Slip.Y /= SlipLength;
+		}
+		Slip.Y = FMath::Sign(Slip.Y) * FMath::Sqrt(FMath::Abs(Slip.Y) ); // Square root the Lateral Force
+
+		// Traction, the normalized slip defines how much we are using in each direction
+		Data.TractionsX[Lane] = Slip.X * Data.FrictionsX[Lane];
+		Data.TractionsY[Lane] = Slip.Y * Data.FrictionsY[Lane];
+	}
+}
+
+void FAVS_WheelKernel::TractionVector(FAVS_WheelKernelData& Data)
+{
+	check(Data.Num() % FAVS_WheelKernelData::GroupWidth == 0);
+
+	const VectorRegister4Float Zero = GlobalVectorConstants::FloatZero;
+	const VectorRegister4Float One = GlobalVectorConstants::FloatOne;
+	const VectorRegister4Float MinusOne = GlobalVectorConstants::FloatMinusOne;
+
+	for( int32 Lane = 0; Lane < Data.Num(); Lane += FAVS_WheelKernelData::GroupWidth )
+	{
+		// Groups with a table in every lane are filled by TractionTables, mixed groups are computed whole and overwritten there
+		const FAVS_TireTable* const* GroupTables = &Data.TireTables[Lane];
+		if( GroupTables[0] && GroupTables[1] && GroupTables[2] && GroupTables[3] ) continue;
+
+		VectorRegister4Float SlipX = VectorLoad(&Data.SlipsX[Lane]);
+		VectorRegister4Float SlipY = VectorLoad(&Data.SlipsY[Lane]);
+
+		// Normalize when the slip leaves the friction circle, lanes inside are scaled by 1
+		const VectorRegister4Float SlipLength = VectorSqrt(VectorMultiplyAdd(SlipX, SlipX, VectorMultiply(SlipY, SlipY)));
+		const VectorRegister4Float Scale = VectorDivide(One, VectorMax(SlipLength, One));
+		SlipX = VectorMultiply(SlipX, Scale);
+		SlipY = VectorMultiply(SlipY, Scale);
+
+		// Square root the Lateral Force, same sign rules as FMath::Sign
+		const VectorRegister4Float SignY = VectorSelect(VectorCompareLT(SlipY, Zero), MinusOne, VectorSelect(VectorCompareGT(SlipY, Zero), One, Zero));
+		SlipY = VectorMultiply(SignY, VectorSqrt(VectorAbs(SlipY)));
+
+		VectorStore(VectorMultiply(SlipX, VectorLoad(&Data.FrictionsX[Lane])), &Data.TractionsX[Lane]);
+		VectorStore(VectorMultiply(SlipY, VectorLoad(&Data.FrictionsY[Lane])), &Data.TractionsY[Lane]);
+	}
+}
@@ -0,0 +1,149 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehicleWheelQuery.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+FHitResult FAVS_WheelHit::ToHitResult(const FAVS_WheelRay& Ray) const
+{
+	FHitResult Trace(Ray.Start, Ray.End);
+	Trace.bBlockingHit = bBlockingHit;
+	if( bBlockingHit )
+	{
+		const float TraceLength = FVector::Dist(Ray.Start, Ray.End);
+		Trace.Time = (TraceLength > 0.0f) ? (Distance / TraceLength) : 0.0f;
+		Trace.Distance = Distance;
+		Trace.Location = Location;
+		Trace.ImpactPoint = ImpactPoint;
+		Trace.Normal = ImpactNormal;
+		Trace.ImpactNormal = ImpactNormal;
+		Trace.PhysMaterial = PhysMaterial;
+		Trace.Component = Component;
+		Trace.HitObjectHandle = FActorInstanceHandle(Component.IsValid() ? Component->GetOwner() : nullptr);
+	}
+	return Trace;
+}
+
+bool FAVS_WheelHit::SolveAgainstPlane(const FVector& Start, const FVector& End, FAVS_WheelHit& OutHit) const
+{
+	OutHit = *this;
+	OutHit.bBlockingHit = false;
+	if( !bBlockingHit ) return false;
+
+	const FVector Ray = End - Start;
+	const double Denominator = FVector::DotProduct(Ray, ImpactNormal);
+	if( Denominator > -UE_KINDA_SMALL_NUMBER ) return false; // Parallel to or facing away from the surface
+
+	const double Time = FVector::DotProduct(ImpactPoint - Start, ImpactNormal) / Denominator;
+	if( Time < 0.0 || Time > 1.0 ) return false; // Plane is out of the suspension's reach
+
+	OutHit.bBlockingHit = true;
+	OutHit.ImpactPoint = Start + Ray * Time;
+	OutHit.Location = OutHit.ImpactPoint;
+	OutHit.Distance = Ray.Size() * Time + DistanceOffset;
+	return true;
+}
+
+int32 FAVS_WheelQueryBatch::AddRay(const FVector& Start, const FVector& End, ECollisionChannel TraceChannel, const FCollisionQueryParams* QueryParams,
+	float SweepRadius, float DistanceOffset)
+{
+	FAVS_WheelRay& Ray = Rays.AddDefaulted_GetRef();
+	Ray.Start = Start;
+	Ray.End = End;
+	Ray.TraceChannel = TraceChannel;
+	Ray.QueryParams = QueryParams;
+	Ray.SweepRadius = SweepRadius;
+	Ray.DistanceOffset = DistanceOffset;
+	return Rays.Num() - 1;
+}
+
+int32 FAVS_WheelQueryBatch::AddProfileRays(const FVector& Start, const FVector& End, const FVector& Forward, float Radius, float Spread, int32 NumRays,
+	ECollisionChannel TraceChannel, const FCollisionQueryParams* QueryParams)
+{
+	// Ground under an outer ray touches the tire ProfileHeight above its bottom, the bottom would reach it ProfileHeight further down.
+	// Flat ground leaves the center ray closest, identical to a single ray
+	const int32 FirstIndex = Rays.Num();
+	for( int32 RIndex = 0; RIndex < NumRays; ++RIndex )
+	{
+		const float Offset = (NumRays > 1) ? Radius * Spread * (2.0f * RIndex / (NumRays - 1) - 1.0f) : 0.0f;
+		const float ProfileHeight = Radius - FMath::Sqrt(FMath::Max(Radius*Radius - Offset*Offset, 0.0f));
+		AddRay(Start + Forward * Offset, End + Forward * Offset, TraceChannel, QueryParams, 0.0f, ProfileHeight);
+	}
+	return FirstIndex;
+}
+
+const FAVS_WheelHit& FAVS_WheelQueryBatch::GetClosestHit(int32 FirstIndex, int32 Count) const
+{
+	const FAVS_WheelHit* Closest = &Hits[FirstIndex];
+	for( int32 Index = FirstIndex + 1; Index < FirstIndex + Count; ++Index )
+	{
+		const FAVS_WheelHit& Hit = Hits[Index];
+		if( Hit.bBlockingHit && (!Closest->bBlockingHit || Hit.Distance < Closest->Distance) )
+		{
+			Closest = &Hit;
+		}
+	}
+	return *Closest;
+}
+
+void FAVS_WheelQueryBatch::Execute(const UWorld* World)
+{
+	Hits.Reset(Rays.Num());
+	if( World == nullptr )
+	{
+		Hits.AddDefaulted(Rays.Num()); // No scene, every wheel is in the air
+		return;
+	}
+
+	for( const FAVS_WheelRay& Ray : Rays )
+	{
+		FAVS_WheelHit& Hit = Hits.AddDefaulted_GetRef();
+
+		FHitResult Trace;
+		const FCollisionQueryParams& Params = Ray.QueryParams ? *Ray.QueryParams : FCollisionQueryParams::DefaultQueryParam;
+		if( Ray.SweepRadius > 0.0f )
+		{
+			// Sphere top starts at Start and its bottom ends at End, so the distance its bottom travelled matches a line's
+			const FVector Direction = (Ray.End - Ray.Start).GetSafeNormal();
+			const FVector SweepStart = Ray.Start + Direction * Ray.SweepRadius;
+			const FVector SweepEnd = Ray.End - Direction * Ray.SweepRadius;
+			if( World->SweepSingleByChannel(Trace, SweepStart, SweepEnd, FQuat::Identity, Ray.TraceChannel, FCollisionShape::MakeSphere(Ray.SweepRadius), Params) )
+			{
+				Hit.bBlockingHit = true;
+				Hit.Distance = Trace.Distance + 2.0f * Ray.SweepRadius + Ray.DistanceOffset;
+				Hit.Location = Ray.Start + Direction * Hit.Distance; // Where a line would have touched, ImpactPoint is the real contact
+				Hit.ImpactPoint = Trace.ImpactPoint;
+				Hit.ImpactNormal = Trace.ImpactNormal;
+				Hit.PhysMaterial = Trace.PhysMaterial;
+				Hit.Component = Trace.Component;
+				Hit.bStaticComponent = Trace.Component.IsValid() && Trace.Component->Mobility == EComponentMobility::Static;
+				Hit.bSweepHit = true;
+			}
+			continue;
+		}
+
+		if( World->LineTraceSingleByChannel(Trace, Ray.Start, Ray.End, Ray.TraceChannel, Params) )
+		{
+			Hit.bBlockingHit = true;
+			Hit.Distance = Trace.Distance + Ray.DistanceOffset;
+			Hit.DistanceOffset = Ray.DistanceOffset;
+			Hit.Location = Trace.Location;
+			Hit.ImpactPoint = Trace.ImpactPoint;
+			Hit.ImpactNormal = Trace.ImpactNormal;
+			Hit.PhysMaterial = Trace.PhysMaterial;
+			Hit.Component = Trace.Component;
+			Hit.bStaticComponent = Trace.Component.IsValid() && Trace.Component->Mobility == EComponentMobility::Static;
+		}
+	}
+}
+
+FCollisionQueryParams FAVS_WheelQueryBatch::MakeQueryParams(const AActor* Vehicle, const TArray<AActor*>& IgnoreActors)
+{
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(AVS_WheelTrace), true, Vehicle); // Trace complex and ignore the vehicle itself
+	Params.bReturnPhysicalMaterial = true; // Needed for surface friction
+	Params.AddIgnoredActors(IgnoreActors);
+	return Params;
+}
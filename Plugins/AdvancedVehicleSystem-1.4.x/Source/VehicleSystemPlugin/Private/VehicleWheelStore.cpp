@@ -0,0 +1,86 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#include "VehicleWheelStore.h"
+
+#include "VehicleWheelQuery.h"
+
+void FAVS_WheelStore::SetNum(int32 NumWheels)
+{
+	if( NumWheels == Num() )
+		return;
+
+	LocalTransforms.SetNum(NumWheels);
+	SpringLengths.SetNumZeroed(NumWheels);
+	SpringStrengths.SetNumZeroed(NumWheels);
+	SpringDampings.SetNumZeroed(NumWheels);
+	Radii.SetNumZeroed(NumWheels);
+	Inertias.SetNumZeroed(NumWheels);
+	BrakeTorques.SetNumZeroed(NumWheels);
+	RollingResistances.SetNumZeroed(NumWheels);
+	MaxSteeringAngles.SetNumZeroed(NumWheels);
+	TireFrictions.SetNumZeroed(NumWheels);
+	SlipSubsteps.Init(1, NumWheels);
+	TireTables.SetNum(NumWheels);
+	Flags.SetNumZeroed(NumWheels);
+	WheelModes.SetNumZeroed(NumWheels);
+	TraceChannels.SetNumZeroed(NumWheels);
+	ContactModels.SetNumZeroed(NumWheels);
+	ContactRayCounts.Init(1, NumWheels);
+	ContactRaySpreads.SetNumZeroed(NumWheels);
+	ContactSweepRadii.SetNumZeroed(NumWheels);
+	WheelPrims.SetNumZeroed(NumWheels);
+	QueryParams.SetNum(NumWheels);
+	QueryIgnoreActors.SetNum(NumWheels);
+	QueryParamsBuilt.Init(false, NumWheels); // Rebuild the trace params of every wheel
+
+	Slips.SetNumZeroed(NumWheels);
+	AngularVelocities.SetNumZeroed(NumWheels);
+	WorldTransforms.SetNum(NumWheels);
+	QueryIndices.Init(INDEX_NONE, NumWheels);
+	QueryCounts.Init(1, NumWheels);
+	LastHits.SetNum(NumWheels);
+	SolvedHits.SetNum(NumWheels);
+	LastTraceLocations.SetNumZeroed(NumWheels);
+	LastTraceSteps.SetNumZeroed(NumWheels);
+}
+
+void FAVS_WheelStore::SetWheelConfig(int32 WIndex, const FAVS1_Wheel_Config& Config, const TSharedPtr<const FAVS_TireTable, ESPMode::ThreadSafe>& TireTable, const AActor* Vehicle)
+{
+	LocalTransforms[WIndex] = Config.WheelLocalTransform;
+	SpringLengths[WIndex] = Config.SpringLength;
+	SpringStrengths[WIndex] = Config.SpringStrength;
+	SpringDampings[WIndex] = Config.SpringDamping;
+	Radii[WIndex] = Config.WheelRadius;
+	Inertias[WIndex] = Config.Inertia;
+	BrakeTorques[WIndex] = Config.BrakeTorque;
+	RollingResistances[WIndex] = Config.RollingResistance;
+	MaxSteeringAngles[WIndex] = Config.MaxSteeringAngle;
+	TireFrictions[WIndex] = Config.TireFriction;
+	SlipSubsteps[WIndex] = static_cast<uint8>(FMath::Clamp(Config.SlipSubsteps, 1, 16));
+	TireTables[WIndex] = TireTable;
+	WheelModes[WIndex] = Config.WheelMode;
+	TraceChannels[WIndex] = Config.TraceChannel;
+	ContactModels[WIndex] = Config.ContactModel;
+	ContactRayCounts[WIndex] = static_cast<uint8>(FMath::Clamp(Config.ContactRayCount | 1, 3, 9)); // Odd, the center ray keeps flat ground identical to SingleRay
+	ContactRaySpreads[WIndex] = FMath::Clamp(Config.ContactRaySpread, 0.1f, 0.95f);
+	ContactSweepRadii[WIndex] = FMath::Clamp(Config.ContactSweepRadius, 1.0f, Config.WheelRadius);
+	WheelPrims[WIndex] = Config.WheelPrim;
+
+	uint8 NewFlags = 0;
+	if( Config.IsDrivingWheel ) NewFlags |= WF_Driving;
+	if( Config.IsSteerableWheel ) NewFlags |= WF_Steerable;
+	if( Config.InvertTorque ) NewFlags |= WF_InvertTorque;
+	if( Config.InvertSteering ) NewFlags |= WF_InvertSteering;
+	if( Config.IsBrakingWheel ) NewFlags |= WF_Braking;
+	if( Config.IsHandbrakeWheel ) NewFlags |= WF_Handbrake;
+	Flags[WIndex] = static_cast<uint8>(NewFlags | (Flags[WIndex] & WF_Locked)); // Keep the dynamic flags
+
+	// Building the params allocates, only do it when the ignore list changes
+	if( !QueryParamsBuilt[WIndex] || QueryIgnoreActors[WIndex] != Config.TraceIgnoreActors )
+	{
+		QueryParams[WIndex] = FAVS_WheelQueryBatch::MakeQueryParams(Vehicle, Config.TraceIgnoreActors);
+		QueryIgnoreActors[WIndex] = Config.TraceIgnoreActors;
+		QueryParamsBuilt[WIndex] = true;
+	}
+}
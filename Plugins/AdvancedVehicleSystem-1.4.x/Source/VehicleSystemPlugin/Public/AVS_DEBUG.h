@@ -4,10 +4,48 @@
 
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
 #include "AVS_DEBUG.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogAVS, Log, All);
 
+// ** Profiling ** //
+
+// "stat AVS" in game, the same scopes show up by name in Unreal Insights
+DECLARE_STATS_GROUP(TEXT("AVS"), STATGROUP_AVS, STATCAT_Advanced);
+
+// Physics thread
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Physics Step"), STAT_AVS_PhysicsStep, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Gather Wheel Queries"), STAT_AVS_GatherQueries, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Wheel Traces"), STAT_AVS_WheelTraces, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Vehicle Physics Tick"), STAT_AVS_PhysicsTick, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Wheel Contacts"), STAT_AVS_Contacts, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Suspension"), STAT_AVS_Suspension, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Friction"), STAT_AVS_Friction, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Forces"), STAT_AVS_ApplyForces, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+
+// Game thread
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Always Tick"), STAT_AVS_AlwaysTick, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Marshal Inputs"), STAT_AVS_MarshalIn, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Marshal Outputs"), STAT_AVS_MarshalOut, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Wheel Visuals"), STAT_AVS_WheelVisuals, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Net Receive"), STAT_AVS_NetReceive, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Net Interpolate"), STAT_AVS_NetInterpolate, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+
+// Counters
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Vehicles"), STAT_AVS_ActiveVehicles, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Passive Vehicles"), STAT_AVS_PassiveVehicles, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Simulated Vehicles (Last Step)"), STAT_AVS_SimulatedVehicles, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Wheel Traces (Last Step)"), STAT_AVS_TracesPerStep, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Net States Queued"), STAT_AVS_StatesQueued, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Net States Dropped"), STAT_AVS_StatesDropped, STATGROUP_AVS, VEHICLESYSTEMPLUGIN_API);
+
+// Cycle counter and Insights scope for one stage, Stage is the stat name without STAT_AVS_
+#define AVS_SCOPE_CYCLE_COUNTER(Stage) \
+	SCOPE_CYCLE_COUNTER(STAT_AVS_##Stage); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(AVS_##Stage)
+
 // Global debug toggle
 #define AVS_DEBUG_ENABLED false
 
@@ -0,0 +1,89 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VehicleDrivetrain.generated.h"
+
+USTRUCT(BlueprintType)
+struct FVehicleGear
+{
+	GENERATED_BODY()
+
+	/** Maximum speed of the gear */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
+	float EndSpeed = 0.0f;
+
+	/** Speed at which this gear will be at its maximum torque */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
+	float StartSpeed = 0.0f;
+
+	/** Automatic Transmission Only, Transmission chooses a new gear when above this speed */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
+	float UpShift = 0.0f;
+
+	/** Automatic Transmission Only, Transmission chooses a new gear when below this speed */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
+	float DownShift = 0.0f;
+
+	/** RPM at the EndSpeed of the gear */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
+	float HighRPM = 0.0f;
+
+	/** RPM at the StartSpeed of the gear */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
+	float LowRPM = 0.0f;
+
+	/** Torque at the StartSpeed of the gear */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
+	float MaxTorque = 0.0f;
+
+	/** Torque at the EndSpeed of the gear */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
+	float MinTorque = 0.0f;
+};
+
+UENUM(BlueprintType)
+enum class EVehicleDifferential : uint8
+{
+	Open,		// Equal torque to every driving wheel
+	LimitedSlip	// Shifts torque towards the driving wheels with the most grip
+};
+
+// Drivetrain setup for the physics thread, rebuilt by AVehicleSystemBase::UpdateDrivetrain and never changed afterwards
+struct FAVS_DrivetrainConfig
+{
+	TArray<FVehicleGear> Gears;
+	TArray<float> TorqueTable; // Engine torque multiplier, one sample every TorqueTableStep RPM
+	float TorqueTableStep = 100.0f;
+	float SpeedScale = 0.036f; // cm/s to the speed unit of Gears
+	float ShiftTime = 0.2f; // s without drive torque while shifting
+	EVehicleDifferential Differential = EVehicleDifferential::Open;
+	float LimitedSlipLocking = 0.5f; // 0 - 1, share of the torque sent by grip
+
+	float GetTorqueMultiplier(float RPM) const
+	{
+		if( TorqueTable.Num() == 0 ) return 1.0f;
+		const float Sample = FMath::Clamp(RPM / TorqueTableStep, 0.0f, float(TorqueTable.Num() - 1));
+		const int32 Index = FMath::Min(static_cast<int32>(Sample), TorqueTable.Num() - 2);
+		return Index < 0 ? TorqueTable[0] : FMath::Lerp(TorqueTable[Index], TorqueTable[Index + 1], Sample - Index);
+	}
+};
+
+// Physics thread only, kept by the vehicle between steps
+struct FAVS_DrivetrainState
+{
+	int32 Gear = 0; // Index into Gears
+	float EngineRPM = 0.0f;
+	float ShiftTimer = 0.0f; // Time left in the current shift
+};
+
+struct VEHICLESYSTEMPLUGIN_API FAVS_Drivetrain
+{
+	// Automatic gear selection for ForwardSpeed (cm/s), returns the total drive torque in Nm for Throttle
+	static float StepEngine(const FAVS_DrivetrainConfig& Config, FAVS_DrivetrainState& State, float ForwardSpeed, float Throttle, float DeltaTime);
+
+	// Splits TotalTorque between the driving wheels, Grips is 0 for wheels without contact
+	static void SplitTorque(const FAVS_DrivetrainConfig& Config, float TotalTorque, TConstArrayView<float> Grips, TArrayView<float> OutTorques);
+};
@@ -0,0 +1,53 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VehicleWheelKernel.h"
+
+// Everything the slip model needs for one wheel with contact, filled by the caller from the wheel config and trace
+struct FAVS_WheelSlipInput
+{
+	float DeltaTime = 0.0f; // s
+	float SuspensionForceN = 0.0f; // Output of FAVS_WheelKernel::Suspension
+	float WheelRadius = 30.0f; // cm
+	float Inertia = 1.0f; // kg*m^2
+	float BrakeTorque = 0.0f; // Nm at full brake input
+	float RollingResistance = 0.0f; // 0 - 1, minimum brake input
+	FVector2D Friction = FVector2D(1.0f, 1.0f); // Tire friction * surface friction
+
+	float RollingVelocity = 0.0f; // Wheel forward velocity in cm/s, not projected
+	FVector2D ContactVelocityM = FVector2D::ZeroVector; // Wheel velocity projected onto the contact plane in the wheel frame, m/s
+	float ContactSpeedM = 0.0f; // Length of the projected velocity, m/s
+	float SlipAngle = 0.0f; // Degrees
+
+	float Throttle = 0.0f; // 0 - 1
+	float Brake = 0.0f; // 0 - 1, already zero for wheels that do not brake
+	float DriveTorque = 0.0f; // Signed drive torque, zero for wheels that are not driven
+	bool Locked = false; // Handbrake or locked by gameplay
+	bool SnapSlip = false; // Slip is set to its target instead of relaxing towards it, reduced simulation tiers
+};
+
+/**
+ * Tire and suspension model with no engine object dependencies, shared by AVS_PhysicsTick and the benchmark.
+ * Given the same inputs and state every function returns the same result, nothing is read from the world.
+ */
+struct VEHICLESYSTEMPLUGIN_API FAVS_DynamicsCore
+{
+	// Moves the wheel slip towards the target set by drive/brake torque and slip angle, updates the angular velocity in rad/s
+	static void StepSlip(const FAVS_WheelSlipInput& Input, FVector2D& InOutSlip, float& InOutAngularVelocity);
+
+	// Integrates the angular velocity from drive, brake and tire torque over NumSubsteps equal steps against the same contact.
+	// Slip relaxes as far per step as with StepSlip whatever the substep count, OutAverageSlip gives the one traction force applied for the whole step
+	static void StepSlipSubsteps(const FAVS_WheelSlipInput& Input, int32 NumSubsteps, FVector2D& InOutSlip, float& InOutAngularVelocity, FVector2D& OutAverageSlip);
+
+	// Suspension, slip and traction of every lane in Data, Slips/AngularVelocities are indexed by lane
+	static void StepWheels(FAVS_WheelKernelData& Data, float AntiGravityN, TConstArrayView<FAVS_WheelSlipInput> SlipInputs,
+		TArrayView<FVector2D> Slips, TArrayView<float> AngularVelocities);
+
+#if !UE_BUILD_SHIPPING
+	// Steps NumWheels synthetic wheels NumSteps times, returns nanoseconds per wheel step and a checksum of the final state
+	static double Benchmark(int32 NumWheels, int32 NumSteps, uint32& OutChecksum);
+#endif
+};
@@ -0,0 +1,48 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Chaos/Core.h"
+
+class UPrimitiveComponent;
+
+namespace Chaos
+{
+	class FRigidBodyHandle_Internal;
+}
+
+/**
+ * Per vehicle list of forces and torques computed on the physics thread.
+ * Vehicles can be simulated in parallel, so nothing is written to the rigid bodies until Apply is called from a single thread.
+ */
+struct FAVS_ForceAccumulator
+{
+	struct FBodyForce
+	{
+		Chaos::FRigidBodyHandle_Internal* Body = nullptr;
+		Chaos::FVec3 Force = Chaos::FVec3(0.0);
+		Chaos::FVec3 Torque = Chaos::FVec3(0.0);
+	};
+
+	// One entry per body, forces on the same body are summed
+	TArray<FBodyForce> Bodies;
+
+	// Keeps allocations, the accumulator is reused every physics step
+	void Reset() { Bodies.Reset(); }
+
+	void AddForce(UPrimitiveComponent* Target, const FVector& Force);
+	void AddForceAtLocation(UPrimitiveComponent* Target, const FVector& Location, const FVector& Force);
+
+	// Same as UVehicleSystemFunctions::AVS_ChaosBrakes, the torque is computed now and applied later
+	void AddBrakeTorque(UPrimitiveComponent* Target, float BrakeTorque, float ChaosDelta);
+
+	// Writes every accumulated force to its rigid body, physics thread only
+	void Apply() const;
+
+	static Chaos::FRigidBodyHandle_Internal* GetRigidHandle(UPrimitiveComponent* Target);
+
+private:
+	FBodyForce* FindOrAddBody(UPrimitiveComponent* Target);
+};
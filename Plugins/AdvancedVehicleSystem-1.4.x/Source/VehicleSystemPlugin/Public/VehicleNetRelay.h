@@ -0,0 +1,38 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "VehicleSystemBase.h"
+#include "VehicleNetRelay.generated.h"
+
+class APlayerController;
+
+/**
+ * Added by the server to every player controller, forwards vehicle states to that one connection.
+ * Lets the server pick a send rate per connection instead of multicasting every state to everyone.
+ */
+UCLASS(ClassGroup="VehicleSystem")
+class VEHICLESYSTEMPLUGIN_API UVehicleNetRelay : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UVehicleNetRelay();
+
+	// Server only, creates the relay the first time a controller needs one
+	static UVehicleNetRelay* FindOrAddRelay(APlayerController* PlayerController);
+
+	// Server only, sends State to this connection if the vehicle is relevant and its send interval has passed
+	void RelayState(AVehicleSystemBase* Vehicle, const FNetState& State);
+
+private:
+	// Last time a state of each vehicle was sent to this connection
+	TMap<TWeakObjectPtr<AVehicleSystemBase>, float> LastSendTimes;
+
+	float GetSendInterval(const AVehicleSystemBase* Vehicle, const FVector& ViewLocation, const FRotator& ViewRotation) const;
+
+	UFUNCTION(Client, unreliable)
+	void Client_ReceiveVehicleState(AVehicleSystemBase* Vehicle, FNetState State);
+};
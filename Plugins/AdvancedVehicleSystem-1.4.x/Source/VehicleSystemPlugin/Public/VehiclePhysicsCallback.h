@@ -4,58 +4,218 @@
 #pragma once
 
 #include "VehicleWheelBase.h"
+#include "VehicleWheelQuery.h"
+#include "VehicleForceAccumulator.h"
+#include "VehicleDrivetrain.h"
+#include "VehicleSurfaceGrid.h"
+#include "VehicleTireModel.h"
 #include "PhysicsProxy/SingleParticlePhysicsProxy.h"
 #include "Runtime/Launch/Resources/Version.h"
 
-struct FVehiclePhysicsPhysicsInput : public Chaos::FSimCallbackInput
+class AVehicleSystemBase;
+
+struct FAVS_VehiclePhysicsInput // Per vehicle entry in the world physics input
 {
-	TWeakObjectPtr<UWorld> World;
-	
 	TWeakObjectPtr<APawn> VehicleActor; //Has to be a pawn to avoid circular references
-	UPrimitiveComponent* VehicleMeshPrim;
+	UPrimitiveComponent* VehicleMeshPrim = nullptr;
 	float VehicleMass = 0.0f;
 
 	FAVS_Inputs VehicleInputs;
-	
-	TArray<FAVS1_Wheel_Config> Wheels;
+	EVehicleSimulationTier SimulationTier = EVehicleSimulationTier::Full;
+
+	// Wheels on static ground reuse their last contact plane while they stay within Tolerance (cm) for at most MaxSteps, 0 disables it
+	float ContactCacheTolerance = 0.0f;
+	uint32 ContactCacheMaxSteps = 0;
+
+	// World's baked ground, null when the vehicle always traces
+	TSharedPtr<const FAVS_SurfaceGridData, ESPMode::ThreadSafe> SurfaceGrid;
+
+	// Set while the native drivetrain is used, VehicleInputs.Torque is ignored then
+	TSharedPtr<const FAVS_DrivetrainConfig, ESPMode::ThreadSafe> Drivetrain;
+
+	// Range of this vehicle's wheels in FVehiclePhysicsPhysicsInput::Wheels
+	int32 FirstWheel = 0;
+	int32 NumWheels = 0;
+
+	// Range in FVehiclePhysicsPhysicsInput::WheelConfigs, only set while the physics thread has not applied WheelConfigVersion
+	int32 FirstWheelConfig = INDEX_NONE;
+	int32 WheelConfigVersion = 0;
+};
+
+struct FVehiclePhysicsPhysicsInput : public Chaos::FSimCallbackInput
+{
+	TWeakObjectPtr<UWorld> World;
+	float GravityZ = 0.0f;
+
+	// Every vehicle that ticked this frame, wheels of all vehicles are packed into one array
+	TArray<FAVS_VehiclePhysicsInput> Vehicles;
+	TArray<FAVS_WheelDynamicInput> Wheels;
+
+	// Full wheel configs, only for vehicles whose config changed since the physics thread last applied it
+	TArray<FAVS1_Wheel_Config> WheelConfigs;
+	// Tire table of each entry in WheelConfigs, resolved on the game thread since the tire model can rebake it at any time
+	TArray<TSharedPtr<const FAVS_TireTable, ESPMode::ThreadSafe>> WheelTireTables;
+
+	TConstArrayView<FAVS_WheelDynamicInput> GetVehicleWheels(const FAVS_VehiclePhysicsInput& Vehicle) const
+	{
+		return MakeArrayView(Wheels.GetData() + Vehicle.FirstWheel, Vehicle.NumWheels);
+	}
+
+	TConstArrayView<FAVS1_Wheel_Config> GetVehicleWheelConfigs(const FAVS_VehiclePhysicsInput& Vehicle) const
+	{
+		if( Vehicle.FirstWheelConfig == INDEX_NONE ) return TConstArrayView<FAVS1_Wheel_Config>();
+		return MakeArrayView(WheelConfigs.GetData() + Vehicle.FirstWheelConfig, Vehicle.NumWheels);
+	}
+
+	TConstArrayView<TSharedPtr<const FAVS_TireTable, ESPMode::ThreadSafe>> GetVehicleWheelTireTables(const FAVS_VehiclePhysicsInput& Vehicle) const
+	{
+		if( Vehicle.FirstWheelConfig == INDEX_NONE ) return TConstArrayView<TSharedPtr<const FAVS_TireTable, ESPMode::ThreadSafe>>();
+		return MakeArrayView(WheelTireTables.GetData() + Vehicle.FirstWheelConfig, Vehicle.NumWheels);
+	}
 
 	void Reset() //Required
 	{
-		VehicleActor = nullptr;
-		VehicleMeshPrim = nullptr;
-		VehicleMass = 0.0f;
-		Wheels.Reset();
 		World.Reset();
+		GravityZ = 0.0f;
+		Vehicles.Reset();
+		Wheels.Reset();
+		WheelConfigs.Reset();
+		WheelTireTables.Reset();
 	}
-}; 
-struct FVehiclePhysicsPhysicsOutput : public Chaos::FSimCallbackOutput
+};
+
+struct FAVS_VehiclePhysicsOutput // Per vehicle entry in the world physics output
 {
-	float ChaosDeltaTime = 0.0f;
-	
+	TWeakObjectPtr<APawn> VehicleActor;
+
 	// Raycast wheel data
 	TArray<FHitResult> DebugTraces; // Raw trace data generated on physics thread
 	TArray<FDebugForce> DebugForces; // Forces applied to the vehicle
 	TArray<FString> DebugTexts;
-	
+
 	TArray<FAVS1_Wheel_Output> WheelOutputs;
-	
+
+	// Wheel config version the physics thread simulated with, configs stop being sent once this matches
+	int32 WheelConfigVersion = 0;
+
+	// Native drivetrain state for HUD/audio
+	int32 Gear = 0;
+	float EngineRPM = 0.0f;
+
+	// Keeps the array allocations, outputs are pooled and refilled every step
+	void Reset()
+	{
+		VehicleActor.Reset();
+		WheelConfigVersion = 0;
+		Gear = 0;
+		EngineRPM = 0.0f;
+		DebugTraces.Reset();
+		DebugForces.Reset();
+		DebugTexts.Reset();
+		WheelOutputs.Reset();
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return DebugTraces.GetAllocatedSize() + DebugForces.GetAllocatedSize() + DebugTexts.GetAllocatedSize() + WheelOutputs.GetAllocatedSize();
+	}
+};
+
+struct FVehiclePhysicsPhysicsOutput : public Chaos::FSimCallbackOutput
+{
+	float ChaosDeltaTime = 0.0f;
+
+	// Entries past NumVehicles are unused but kept, so their buffers are reused by the next step written to this output
+	TArray<FAVS_VehiclePhysicsOutput> Vehicles;
+	int32 NumVehicles = 0;
+
+	int32 AddVehicle(const TWeakObjectPtr<APawn>& VehicleActor)
+	{
+		if( NumVehicles == Vehicles.Num() )
+		{
+			Vehicles.AddDefaulted();
+		}
+		FAVS_VehiclePhysicsOutput& Vehicle = Vehicles[NumVehicles];
+		Vehicle.Reset();
+		Vehicle.VehicleActor = VehicleActor;
+		return NumVehicles++;
+	}
+
+	TArrayView<FAVS_VehiclePhysicsOutput> GetVehicles()
+	{
+		return MakeArrayView(Vehicles.GetData(), NumVehicles);
+	}
+
 	void Reset() //Required
 	{
 		ChaosDeltaTime = 0.0f;
-		DebugTraces.Empty();
-		DebugForces.Empty();
-		DebugTexts.Empty();
-		WheelOutputs.Empty();
+		NumVehicles = 0;
 	}
 };
 
-// Unreal 5.1+ Physics Callback
-class FVehiclePhysicsCallback : public Chaos::TSimCallbackObject<FVehiclePhysicsPhysicsInput, FVehiclePhysicsPhysicsOutput, Chaos::ESimCallbackOptions::Presimulate | Chaos::ESimCallbackOptions::ContactModification>
+// Newest physics output of one vehicle on the game thread. Buffers are swapped with the pooled entry instead of copied,
+// the entry goes back to the output pool holding this vehicle's previous buffers so neither side allocates once warmed up
+struct FAVS_LatestPhysicsOutput : public FAVS_VehiclePhysicsOutput
+{
+	float ChaosDeltaTime = 0.0f;
+	bool HasNew = false; // Cleared by the vehicle once read
+	uint64 Frame = 0; // Game frame of the last received output
+
+	// Takes the buffers of PooledOutput unless an output was already received in InFrame
+	bool Receive(uint64 InFrame, float InChaosDeltaTime, FAVS_VehiclePhysicsOutput& PooledOutput)
+	{
+		if( Frame == InFrame )
+			return false;
+
+		Frame = InFrame;
+		ChaosDeltaTime = InChaosDeltaTime;
+		HasNew = true;
+		Swap(static_cast<FAVS_VehiclePhysicsOutput&>(*this), PooledOutput);
+		return true;
+	}
+
+	// Outputs popped in InFrame, oldest first. Every vehicle receives its newest entry, older ones are skipped without being copied.
+	// FindLatest returns nullptr for vehicles that are gone
+	template<typename OutputHandleType>
+	static void HandOut(TArrayView<OutputHandleType> Outputs, uint64 InFrame, TFunctionRef<FAVS_LatestPhysicsOutput*(const FAVS_VehiclePhysicsOutput&)> FindLatest)
+	{
+		for( int32 OutputIndex = Outputs.Num() - 1; OutputIndex >= 0; --OutputIndex )
+		{
+			FVehiclePhysicsPhysicsOutput* PhysicsOutput = Outputs[OutputIndex].Get();
+			for( FAVS_VehiclePhysicsOutput& VehicleOutput : PhysicsOutput->GetVehicles() )
+			{
+				if( FAVS_LatestPhysicsOutput* Latest = FindLatest(VehicleOutput) )
+				{
+					Latest->Receive(InFrame, PhysicsOutput->ChaosDeltaTime, VehicleOutput);
+				}
+			}
+		}
+	}
+};
+
+// Unreal 5.1+ Physics Callback, one per world shared by every vehicle (owned by UVehiclePhysicsSubsystem)
+// Wheel/chassis pairs are filtered in the broadphase, so no contact modification is registered here
+class FVehiclePhysicsCallback : public Chaos::TSimCallbackObject<FVehiclePhysicsPhysicsInput, FVehiclePhysicsPhysicsOutput, Chaos::ESimCallbackOptions::Presimulate>
 {
 public:
-	Chaos::FSingleParticlePhysicsProxy* VehicleMesh;
-	TArray<Chaos::FSingleParticlePhysicsProxy*> WheelMeshes;
+	// Physics thread only! Replaces the meshes ignored by the vehicle, an empty array removes all of its pairs.
+	// Unique indices are resolved on the game thread, pairs are removed by index since their proxies may already be destroyed
+	void SetDisabledCollisions_Internal(Chaos::FUniqueIdx VehicleIdx, Chaos::FSingleParticlePhysicsProxy* VehicleProxy,
+		const TArray<Chaos::FUniqueIdx>& WheelIndices, const TArray<Chaos::FSingleParticlePhysicsProxy*>& WheelProxies);
 private:
+	// Pairs registered with the solver's ignore collision manager by vehicle, kept so they can be removed again
+	TMap<Chaos::FUniqueIdx, TArray<Chaos::FUniqueIdx>> DisabledCollisions;
+
+	struct FSimulatedVehicle
+	{
+		AVehicleSystemBase* Vehicle;
+		int32 InputIndex;
+		int32 OutputIndex;
+	};
+	TArray<FSimulatedVehicle> SimulatedVehicles; // Vehicles simulated in the current step
+	TArray<FAVS_ForceAccumulator> VehicleForces; // Forces of each simulated vehicle, applied after all vehicles are done
+
+	FAVS_WheelQueryBatch WheelQueries; // Reused every step to avoid reallocating the ray/hit arrays
+
 	virtual void OnPreSimulate_Internal() override;
-	virtual void OnContactModification_Internal(Chaos::FCollisionContactModifier& Modifier) override;
-};
\ No newline at end of file
+};
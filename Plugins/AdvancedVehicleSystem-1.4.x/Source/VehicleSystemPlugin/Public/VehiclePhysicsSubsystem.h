@@ -0,0 +1,70 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "VehiclePhysicsCallback.h"
+#include "VehiclePhysicsSubsystem.generated.h"
+
+class AVehicleSystemBase;
+class UVehicleSurfaceGrid;
+
+/**
+ * Owns the single physics callback of a world and the registry of vehicles simulated by it.
+ * The callback is created by the first registered vehicle and lives as long as the subsystem.
+ * Vehicles add themselves to the shared input every frame, outputs are handed back once per frame.
+ * Ticks to drain the outputs itself on frames where every registered vehicle is asleep.
+ */
+UCLASS()
+class VEHICLESYSTEMPLUGIN_API UVehiclePhysicsSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+private:
+	FVehiclePhysicsCallback* PhysicsCallback = nullptr;
+
+	UPROPERTY()
+	TArray<AVehicleSystemBase*> RegisteredVehicles;
+
+	// Frame the physics outputs were last distributed, outputs are only popped once per frame
+	uint64 LastOutputFrame = 0;
+
+	UPROPERTY()
+	UVehicleSurfaceGrid* SurfaceGrid = nullptr;
+
+	// Outputs popped this frame, only held while they are distributed
+	TArray<Chaos::TSimCallbackOutputHandle<FVehiclePhysicsPhysicsOutput>> PendingOutputs;
+
+	bool CreatePhysicsCallback();
+	void DestroyPhysicsCallback();
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UVehiclePhysicsSubsystem, STATGROUP_Tickables); }
+
+	// Registers the vehicle with the world physics callback, creates the callback if needed
+	bool RegisterVehicle(AVehicleSystemBase* Vehicle);
+	void UnregisterVehicle(AVehicleSystemBase* Vehicle);
+	bool IsVehicleRegistered(const AVehicleSystemBase* Vehicle) const { return RegisteredVehicles.Contains(Vehicle); }
+
+	const TArray<AVehicleSystemBase*>& GetRegisteredVehicles() const { return RegisteredVehicles; }
+
+	// Shared input for the next physics step, every vehicle appends its own entry
+	FVehiclePhysicsPhysicsInput* GetProducerInput_External();
+
+	// Pops all pending physics outputs and hands each vehicle its most recent data
+	void UpdatePhysicsOutputs_External();
+
+	// Baked ground of this world, raycast wheels read it before tracing. Usually set by the level blueprint, null to always trace
+	UFUNCTION(BlueprintCallable, Category = "Vehicle System Plugin")
+	void SetSurfaceGrid(UVehicleSurfaceGrid* NewSurfaceGrid) { SurfaceGrid = NewSurfaceGrid; }
+
+	UFUNCTION(BlueprintPure, Category = "Vehicle System Plugin")
+	UVehicleSurfaceGrid* GetSurfaceGrid() const { return SurfaceGrid; }
+
+	// Replaces the meshes that should not collide with VehicleProxy, an empty array removes the vehicle
+	void SetDisabledCollisions(Chaos::FSingleParticlePhysicsProxy* VehicleProxy, const TArray<Chaos::FSingleParticlePhysicsProxy*>& WheelProxies);
+};
@@ -0,0 +1,77 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#pragma once
+
+#include "GameFramework/Info.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "VehicleSystemBase.h"
+#include "VehicleRestManager.generated.h"
+
+USTRUCT()
+struct FAVS_RestEntry : public FFastArraySerializerItem // Rest transform of one parked vehicle
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	AVehicleSystemBase* Vehicle = nullptr;
+
+	UPROPERTY()
+	FNetState State;
+
+	void PreReplicatedRemove(const struct FAVS_RestArray& InArraySerializer);
+	void PostReplicatedAdd(const struct FAVS_RestArray& InArraySerializer);
+	void PostReplicatedChange(const struct FAVS_RestArray& InArraySerializer);
+};
+
+USTRUCT()
+struct FAVS_RestArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FAVS_RestEntry> Items;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FAVS_RestEntry, FAVS_RestArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FAVS_RestArray> : public TStructOpsTypeTraitsBase2<FAVS_RestArray>
+{
+	enum { WithNetDeltaSerializer = true };
+};
+
+/**
+ * One per world, spawned by the server the first time a vehicle comes to rest.
+ * Replicates the rest states of every parked vehicle as a single delta serialized array,
+ * so the vehicles themselves can go net dormant until they move again.
+ */
+UCLASS(NotBlueprintable, ClassGroup="VehicleSystem")
+class VEHICLESYSTEMPLUGIN_API AVehicleRestManager : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AVehicleRestManager();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// Manager of World, only the server creates one when Create is true
+	static AVehicleRestManager* Get(UWorld* World, bool Create = false);
+
+	// Server only, adds or updates the vehicle's rest state, a blank state (zero position) removes it
+	void SetRestState(AVehicleSystemBase* Vehicle, const FNetState& State);
+
+	// Server only
+	void RemoveVehicle(const AVehicleSystemBase* Vehicle);
+
+	// Rest state of a vehicle that replicated after its entry did
+	bool FindRestState(const AVehicleSystemBase* Vehicle, FNetState& OutState) const;
+
+private:
+	UPROPERTY(Replicated)
+	FAVS_RestArray RestVehicles;
+};
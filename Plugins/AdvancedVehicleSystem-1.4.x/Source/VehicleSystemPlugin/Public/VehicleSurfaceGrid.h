@@ -0,0 +1,111 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Engine/EngineTypes.h"
+#include "VehicleWheelQuery.h"
+#include "VehicleSurfaceGrid.generated.h"
+
+class UPhysicalMaterial;
+
+struct FAVS_SurfaceTile // TileSize x TileSize samples, row major with Y as the row
+{
+	FIntPoint Coord = FIntPoint::ZeroValue;
+	TArray<float> Heights; // World Z
+	TArray<FVector2f> Normals; // XY of the surface normal, Z is rebuilt since drivable surfaces always face up
+	TArray<uint8> Materials; // Index into FAVS_SurfaceGridData::Materials, InvalidSample where wheels have to trace
+
+	friend FArchive& operator<<(FArchive& Ar, FAVS_SurfaceTile& Tile)
+	{
+		return Ar << Tile.Coord << Tile.Heights << Tile.Normals << Tile.Materials;
+	}
+};
+
+// Baked drivable surface, read by the physics thread and shared by every vehicle in the world
+struct VEHICLESYSTEMPLUGIN_API FAVS_SurfaceGridData
+{
+	static constexpr int32 TileSize = 64;
+	static constexpr uint8 InvalidSample = 255;
+
+	FVector2D Origin = FVector2D::ZeroVector; // World XY of sample (0, 0)
+	float CellSize = 50.0f;
+	FIntPoint NumSamples = FIntPoint::ZeroValue;
+
+	// Only tiles with at least one valid sample are stored
+	TArray<FAVS_SurfaceTile> Tiles;
+	TMap<FIntPoint, int32> TileLookup;
+
+	TArray<TWeakObjectPtr<UPhysicalMaterial>> Materials;
+
+	// Intersects the ray with the baked surface. False where the grid has no answer (unbaked, dynamic, edges, below an overhang), the ray has to be traced then.
+	// True with no blocking hit when the surface is out of the ray's reach
+	bool Trace(const FVector& Start, const FVector& End, FAVS_WheelHit& OutHit) const;
+
+	bool GetSample(int32 X, int32 Y, float& OutHeight, FVector& OutNormal, uint8& OutMaterial) const;
+
+	void BuildLookup();
+};
+
+/**
+ * Height, normal and surface of the static drivable ground of a level, sampled on a regular grid.
+ * Raycast wheels read it before tracing so most of the driving skips the scene query, see UVehiclePhysicsSubsystem::SetSurfaceGrid.
+ * Only static meshes and landscape are baked, vehicles still trace near dynamic objects and at steps or edges of the surface.
+ */
+UCLASS(BlueprintType)
+class VEHICLESYSTEMPLUGIN_API UVehicleSurfaceGrid : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// World area to sample, samples are traced from the top of the box to the bottom
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Surface Grid")
+	FBox BakeBounds = FBox(FVector(-10000.0f, -10000.0f, -5000.0f), FVector(10000.0f, 10000.0f, 5000.0f));
+
+	// Distance between samples, should be smaller than the smallest bump that matters to the suspension
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Surface Grid", meta=(ClampMin="5", Units="cm"))
+	float CellSize = 50.0f;
+
+	// Should match the wheels' trace channel
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Surface Grid")
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECollisionChannel::ECC_Vehicle;
+
+	// Neighbouring samples further than this from the slope between them are a step or an edge, wheels trace there
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Surface Grid", AdvancedDisplay, meta=(ClampMin="0.1", Units="cm"))
+	float DiscontinuityTolerance = 3.0f;
+
+	// Steeper samples are walls, wheels trace there
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Surface Grid", AdvancedDisplay, meta=(ClampMin="0", ClampMax="89", Units="deg"))
+	float MaxSlopeAngle = 60.0f;
+
+	// Bakes with more samples are refused. Baked samples take 13 bytes each and the bake needs about 17 more per sample while it runs,
+	// the default 2048x2048 samples is about 55 MB of grid, a 1x1 km area at 50 cm
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Surface Grid", AdvancedDisplay, meta=(ClampMin="1"))
+	int32 MaxBakeSamples = 2048 * 2048;
+
+	// Surfaces found by the last bake
+	UPROPERTY(VisibleAnywhere, Category = "Surface Grid")
+	TArray<UPhysicalMaterial*> SurfaceMaterials;
+
+	// Samples the static world of WorldContextObject, can also be used at runtime for generated tracks
+	UFUNCTION(BlueprintCallable, Category = "Surface Grid", meta=(WorldContext="WorldContextObject"))
+	void Bake(const UObject* WorldContextObject);
+
+#if WITH_EDITOR
+	// Bakes the level open in the editor
+	UFUNCTION(CallInEditor, Category = "Surface Grid")
+	void BakeEditorWorld();
+#endif
+
+	// Baked data, null until baked
+	TSharedPtr<const FAVS_SurfaceGridData, ESPMode::ThreadSafe> GetGridData() const { return GridData; }
+
+	virtual void Serialize(FArchive& Ar) override;
+	virtual void PostLoad() override;
+
+private:
+	// Replaced as a whole by every bake so vehicles mid step keep the old one
+	TSharedPtr<FAVS_SurfaceGridData, ESPMode::ThreadSafe> GridData;
+};
@@ -6,7 +6,11 @@
 #include "CoreMinimal.h"
 #include "VehicleWheelBase.h"
 #include "VehiclePhysicsCallback.h"
+#include "VehicleWheelStore.h"
+#include "VehicleDynamicsCore.h"
+#include "VehicleDrivetrain.h"
 #include "Engine/World.h"
+#include "Engine/OverlapResult.h"
 #include "GameFramework/Pawn.h"
 #include "Runtime/Engine/Classes/Curves/CurveFloat.h"
 #include "Components/PrimitiveComponent.h"
@@ -14,6 +18,18 @@
 #include "GameFramework/GameStateBase.h"
 #include "VehicleSystemBase.generated.h"
 
+class UVehiclePhysicsSubsystem;
+
+// Size/precision trade-off of replicated vehicle states, see FNetState::NetSerialize
+UENUM(BlueprintType)
+enum class ENetStatePrecision : uint8
+{
+	Low,	// ~18 bytes: 4cm position, 20cm/s velocity
+	Medium,	// ~20 bytes: 2cm position, 10cm/s velocity
+	High,	// ~23 bytes: 1cm position, 2.5cm/s velocity
+	Full	// ~53 bytes: uncompressed floats
+};
+
 USTRUCT(BlueprintType)
 struct FNetState
 {
@@ -32,6 +48,13 @@ struct FNetState
 	UPROPERTY()
 	FVector angularVelocity;
 
+	// Quantization used when this state is sent
+	UPROPERTY()
+	ENetStatePrecision Precision;
+
+	// Set after receiving, NetTimestamp only holds the time within the wrap period until UnwrapTimestamp is called
+	bool TimestampWrapped = false;
+
 	FNetState()
 	{
 		NetTimestamp = 0.0f;
@@ -40,57 +63,81 @@ struct FNetState
 		rotation = FRotator::ZeroRotator;
 		velocity = FVector::ZeroVector;
 		angularVelocity = FVector::ZeroVector;
+		Precision = ENetStatePrecision::Medium;
 	}
-};
 
-UENUM(BlueprintType)
-enum class NetworkRoles : uint8
-{
-	None, Owner, Server, Client, ClientSpawned
+	// Bit packed replication: cell relative position, smallest-three rotation, quantized velocities and a wrapped timestamp
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	// Restores the full timestamp from the wrapped one, ReferenceTime is the receiver's current network time
+	void UnwrapTimestamp(float ReferenceTime);
+
+	// Largest position error introduced by quantization in cm
+	static float GetPositionTolerance(ENetStatePrecision InPrecision);
 };
 
-UENUM(BlueprintType)
-enum class SteeringSmoothingType : uint8
+template<>
+struct TStructOpsTypeTraits<FNetState> : public TStructOpsTypeTraitsBase2<FNetState>
 {
-	Instant, Constant, Ease
+	enum
+	{
+		WithNetSerializer = true,
+	};
 };
 
-USTRUCT(BlueprintType)
-struct FVehicleGear
+// Fixed size queue of received states sorted by NetTimestamp, oldest first
+struct FAVS_NetStateBuffer
 {
-	GENERATED_BODY()
+	static constexpr int32 Capacity = 16;
 
-	/** Maximum speed of the gear */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
-	float EndSpeed = 0.0f;
+	// Returns false if the state is older than the states already played or a duplicate, a full buffer drops its oldest state
+	bool Add(const FNetState& State, float LocalTime);
+	void Reset();
 
-	/** Speed at which this gear will be at its maximum torque */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
-	float StartSpeed = 0.0f;
+	int32 Num() const { return Count; }
+	const FNetState& Get(int32 Index) const { return States[(Head + Index) % Capacity]; }
 
-	/** Automatic Transmission Only, Transmission chooses a new gear when above this speed */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
-	float UpShift = 0.0f;
+	// Sender time that should be shown now, Delay seconds behind the newest states
+	float GetRenderTime(float LocalTime, float Delay) const { return LocalTime - TimeOffset - Delay; }
 
-	/** Automatic Transmission Only, Transmission chooses a new gear when below this speed */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
-	float DownShift = 0.0f;
+	// Drops states that can no longer be sampled, keeps the last state at or before Time
+	void DiscardBefore(float Time);
 
-	/** RPM at the EndSpeed of the gear */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
-	float HighRPM = 0.0f;
+	// Cubic Hermite between the two states around Time, extrapolates at most MaxExtrapolation past the newest state
+	// Returns false if Time is before the oldest state
+	bool Sample(float Time, float MaxExtrapolation, FNetState& OutState) const;
 
-	/** RPM at the StartSpeed of the gear */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
-	float LowRPM = 0.0f;
+private:
+	FNetState States[Capacity];
+	int32 Head = 0;
+	int32 Count = 0;
 
-	/** Torque at the StartSpeed of the gear */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
-	float MaxTorque = 0.0f;
+	// Local time minus sender time of the fastest recent packet, converts local time to sender time
+	float TimeOffset = 0.0f;
+	bool HasTimeOffset = false;
+};
 
-	/** Torque at the EndSpeed of the gear */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
-	float MinTorque = 0.0f;
+USTRUCT()
+struct FAVS_InputFrame // Owner inputs sent to the server in server authoritative mode
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Sequence = 0;
+	UPROPERTY()
+	FAVS_Inputs Inputs;
+};
+
+UENUM(BlueprintType)
+enum class NetworkRoles : uint8
+{
+	None, Owner, Server, Client, ClientSpawned
+};
+
+UENUM(BlueprintType)
+enum class SteeringSmoothingType : uint8
+{
+	Instant, Constant, Ease
 };
 
 UCLASS(Blueprintable, Abstract)
@@ -104,12 +151,96 @@ private:
 
 	// ** Physics Thread ** //
 
-	FVehiclePhysicsCallback* PhysicsThreadCallback;
+	friend class UVehiclePhysicsSubsystem;
+	friend class UVehicleNetRelay;
+	friend struct FAVS_RestEntry;
+
+	// World physics manager that owns the physics callback this vehicle is simulated by
+	UPROPERTY()
+	UVehiclePhysicsSubsystem* PhysicsSubsystem = nullptr;
+
+	// Most recent physics output for this vehicle, swapped in by the physics subsystem
+	FAVS_LatestPhysicsOutput LatestPhysicsOutput;
 
 	UPROPERTY()
 	TArray<UPrimitiveComponent*> ContactModMeshes;
 
-	TArray<FAVS1_Wheel_State> WheelStates;
+	// Wheels sent to the physics thread, cached so the marshal path does not allocate every frame
+	UPROPERTY()
+	TArray<UVehicleWheelBase*> SimulatedWheels;
+	TArray<int32> SimulatedWheelVersions; // Config version of each simulated wheel when it was last sent
+
+	// Bumped whenever a simulated wheel's config or the set of simulated wheels changes
+	int32 WheelConfigVersion = 1;
+	// Last version the physics thread reported back, configs are resent until this matches
+	int32 AppliedWheelConfigVersion = 0;
+
+	void UpdateSimulatedWheels();
+
+	// Adds this vehicle and its wheels to the world's physics input for the next step
+	void MarshalPhysicsInput(FVehiclePhysicsPhysicsInput& PhysicsInput);
+
+	// Persistent physics thread wheel data, one column per field
+	FAVS_WheelStore WheelStore;
+
+	// ** Server Authority ** //
+
+	// Owner side, where the vehicle was predicted to be every frame
+	struct FPredictedState
+	{
+		float Time;
+		int32 Sequence; // Latest input sequence sent at this time
+		FVector Position;
+		FQuat Rotation;
+		FVector Velocity;
+	};
+	TArray<FPredictedState> PredictionHistory; // Ring buffer of NetPredictionHistory entries
+	int32 PredictionHead = 0;
+	TArray<FAVS_InputFrame> RecentInputFrames; // Last few input frames, resent with every new one in case of packet loss
+	int32 InputSequence = 0;
+	float LastInputSendTime = 0.0f;
+	FVector PendingPositionCorrection = FVector::ZeroVector;
+	FQuat PendingRotationCorrection = FQuat::Identity;
+	FVector PendingVelocityCorrection = FVector::ZeroVector;
+
+	// Server side, last input applied from the owner, 0 while no remote owner is driving
+	int32 LastInputSequence = 0;
+	float LastInputTime = 0.0f;
+
+	void SendPredictionInputs();
+	void ApplyServerCorrection();
+
+	// Largest drive torque the server accepts from the owner, 0 for no limit
+	float GetMaxInputTorque() const;
+	void ResetPrediction();
+
+	// Wheels with a trace hit in the current step, kept between steps to reuse the allocations
+	struct FWheelContactData
+	{
+		FVector WheelWorldLocation;
+		FVector ImpactLocation;
+		FVector ImpactNormal;
+		FVector ForwardOnPlane;
+		FVector RightOnPlane;
+		FVector WheelVelocityLocal; // cm/s
+		FVector WheelVelocityLocalM; // Projected onto the contact plane, m/s
+		float WheelVelocity; // m/s
+		float SlipAngle; // Degrees
+		float SurfaceFriction;
+	};
+	TArray<FWheelContactData> WheelContactData;
+	FAVS_WheelKernelData WheelKernelData; // Same lanes as WheelContactData, padded for the vector kernels
+
+	// Chassis transform for the current physics step
+	FTransform PhysicsBodyTransform;
+	uint32 PhysicsStepCount = 0; // Spreads the traces of the lower simulation tiers over steps
+
+	// Native drivetrain, the config is shared with the physics thread and replaced as a whole by UpdateDrivetrain
+	TSharedPtr<const FAVS_DrivetrainConfig, ESPMode::ThreadSafe> DrivetrainConfig;
+	FAVS_DrivetrainState DrivetrainState; // Physics thread only
+	TArray<float> DrivetrainGrips; // Scratch, one entry per driving wheel
+	TArray<float> DrivetrainTorques;
+	TArray<float> WheelDriveTorques; // Per wheel drive torque for the current step
 
 protected: // Accessible by subclasses
 
@@ -123,6 +254,13 @@ protected: // Accessible by subclasses
 
 	float TickDeltaTime = 0.0f;
 	void AlwaysTick();
+
+	void UpdateSimulationTier();
+
+	// Time since the wheel visuals were last updated, far and hidden vehicles update them less often
+	float WheelVisualTime = 0.0f;
+	void UpdateWheelVisuals(float DeltaTime);
+	float GetWheelVisualInterval() const;
 	void PassiveTick(float DeltaTime);
 	void NetworkTick();
 
@@ -146,6 +284,27 @@ protected: // Accessible by subclasses
 
 	void DetermineLocalRestState();
 
+	// Passive vehicle with its tick and physics inputs turned off, only woken up by events
+	bool PassiveSleeping = false;
+	bool SleepRestoreNotifyCollision = false; // bNotifyRigidBodyCollision of the vehicle mesh before sleeping
+	float PassiveWakeTimer = 0.0f; // Passive state is not evaluated until this runs out
+	FTimerHandle PassiveSleepCheckTimer;
+
+	void SetPassiveSleeping(bool NewSleeping);
+	// Asks DeterminePassiveState again while asleep, wakes the vehicle once it is no longer passive
+	void PassiveSleepCheck();
+
+	UFUNCTION()
+	void OnVehicleMeshWake(UPrimitiveComponent* WakingComponent, FName BoneName);
+
+	UFUNCTION()
+	void OnVehicleMeshHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
+	// Meshes in ContactModMeshes losing or getting their physics body, their pairs are sent again so none refers to a destroyed particle
+	UFUNCTION()
+	void OnDisabledMeshPhysicsStateChanged(UPrimitiveComponent* ChangedComponent, EComponentPhysicsStateChange StateChange);
+	void SendDisabledCollisions(const UPrimitiveComponent* SkipMesh = nullptr);
+
 	// ** Networking ** //
 	#pragma region Networking
 
@@ -172,22 +331,69 @@ protected: // Accessible by subclasses
 	float NetSendRate;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Network", AdvancedDisplay)
 	float NetTimeBehind;
+	// Blend time from local physics into the received states when syncing starts
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Network", AdvancedDisplay)
 	float NetLerpStart;
+	// Longest time states are predicted past the newest received state when packets are late
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Network", AdvancedDisplay)
+	float NetMaxExtrapolation;
+	// Server simulates the vehicle from the owner's validated inputs, the owner predicts locally and is smoothly pulled towards server snapshots (inputs are not replayed)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Network", AdvancedDisplay)
+	bool ServerAuthoritative;
+	// Largest Torque input in Nm the server accepts from the owner, 0 uses the highest torque in Gears (no limit without gears)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Network", AdvancedDisplay, meta=(EditCondition="ServerAuthoritative", ClampMin="0"))
+	float NetMaxInputTorque;
+	// Frames of predicted states the owner keeps to compare with server snapshots, must cover the round trip time
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Network", AdvancedDisplay, meta=(EditCondition="ServerAuthoritative", ClampMin="8"))
+	int32 NetPredictionHistory;
+	// Prediction error in cm before the owner is corrected
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Network", AdvancedDisplay, meta=(EditCondition="ServerAuthoritative"))
+	float NetCorrectionThreshold;
+	// Largest correction in cm applied per frame, bigger errors are spread over several frames
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Network", AdvancedDisplay, meta=(EditCondition="ServerAuthoritative"))
+	float NetCorrectionBudget;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Network", AdvancedDisplay)
 	float NetPositionTolerance;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Network", AdvancedDisplay)
 	float NetSmoothing;
-
+	// Resting vehicles hand their rest state to the world's AVehicleRestManager and go net dormant until they move
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Network", AdvancedDisplay)
+	bool UseRestManager;
+	// Lower precision sends smaller states, Full disables compression
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Network", AdvancedDisplay)
+	ENetStatePrecision NetStatePrecision;
+	// Server picks a send rate per connection from NetSendLODCurve instead of multicasting every state to everyone
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Network", AdvancedDisplay)
+	bool UseNetSendLOD;
+	// X: Distance to the player's view in meters, Y: Multiplier of NetSendRate for that player
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Network", AdvancedDisplay, meta=(EditCondition="UseNetSendLOD"))
+	FRuntimeFloatCurve NetSendLODCurve;
+	// Distance multiplier for vehicles behind the player's view, lowers their priority
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Network", AdvancedDisplay, meta=(EditCondition="UseNetSendLOD"))
+	float NetSendLODOutOfViewScale;
+
+	// Only replicated by the vehicle itself when UseRestManager is off
 	UPROPERTY(ReplicatedUsing=OnRep_RestState)
 	FNetState RestState;
 
+	// Rest state received from AVehicleRestManager
+	void ReceiveManagedRestState(const FNetState& State)
+	{
+		RestState = State;
+		OnRep_RestState();
+	}
+
+	// Server only, dormant while resting unless a client needs to send RPCs through this actor
+	void UpdateRestDormancy();
+
 	bool RestThresh = false;
 
 	UFUNCTION()
 	void OnRep_RestState()
 	{
+		RestState.UnwrapTimestamp(GetNetworkWorldTime());
 		NetworkAtRest = (RestState.position != FVector::ZeroVector);
+		if( PassiveSleeping && !IsSimulationAuthority() ) WakeFromPassive(); // Sleeping copies still have to move to the new rest state
 	}
 
 	// Vehicle is considered at rest for network purposes
@@ -205,7 +411,7 @@ protected: // Accessible by subclasses
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "VehicleSystemPlugin")
 	void WakeWheelsForMovement();
 
-	TArray<FNetState> StateQueue;
+	FAVS_NetStateBuffer StateQueue;
 	FNetState LerpStartState;
 	bool CreateNewStartState = true;
 	float LastActiveTimestamp = 0;
@@ -222,11 +428,18 @@ protected: // Accessible by subclasses
 	FNetState CreateNetStateForNow();
 	void AddStateToQueue(FNetState StateToAdd);
 	void ClearQueue();
-	void CalculateTimestamps();
 	void SyncPhysics();
 	void LerpToNetState(FNetState NextState, float CurrentServerTime);
 	void ApplyExactNetState(FNetState State);
 
+	// Decides where the vehicle is: the owner, or the server in server authoritative mode
+	bool IsSimulationAuthority()
+	{
+		const NetworkRoles Role = GetNetworkRole();
+		if( ServerAuthoritative ) return isServer() && (Role == NetworkRoles::Owner || Role == NetworkRoles::Server);
+		return Role == NetworkRoles::Owner;
+	}
+
 	bool isServer()
 	{
 		UWorld* World = GetWorld();
@@ -278,6 +491,13 @@ protected: // Accessible by subclasses
 	void Server_ReceiveRestState(FNetState State);
 	virtual bool Server_ReceiveRestState_Validate(FNetState State);
 	virtual void Server_ReceiveRestState_Implementation(FNetState State);
+	UFUNCTION(Server, unreliable, WithValidation)
+	void Server_ReceiveInputs(const TArray<FAVS_InputFrame>& Frames);
+	virtual bool Server_ReceiveInputs_Validate(const TArray<FAVS_InputFrame>& Frames);
+	virtual void Server_ReceiveInputs_Implementation(const TArray<FAVS_InputFrame>& Frames);
+	UFUNCTION(Client, unreliable)
+	void Client_ReceiveSnapshot(FNetState State, int32 AckSequence, float AckAge);
+	virtual void Client_ReceiveSnapshot_Implementation(FNetState State, int32 AckSequence, float AckAge);
 	UFUNCTION(NetMulticast, reliable, WithValidation)
 	void Multicast_ChangedOwner();
 	virtual bool Multicast_ChangedOwner_Validate();
@@ -293,9 +513,10 @@ protected: // Accessible by subclasses
 	UFUNCTION(BlueprintCallable, Category = "VehicleSystemPlugin")
 	void UpdateInternalWheelArray();
 
-	// Register async callback with physics system.
+	// Register with the world physics callback (UVehiclePhysicsSubsystem)
 	bool IsPhysicsCallbackRegistered();
 	void RegisterPhysicsCallback();
+	void UnregisterPhysicsCallback();
 
 	// AVS internal use only! Sets array of meshes with collisions disabled against the VehicleMesh
 	UFUNCTION(BlueprintCallable, Category = "VehicleSystemPlugin")
@@ -312,6 +533,10 @@ protected: // Accessible by subclasses
 	void PhysicsThreadInputs(FAVS_Inputs NewInputs)
 	{
 		InputsForPhysicsThread = NewInputs;
+		if( PassiveSleeping && (NewInputs.Throttle != 0.0f || NewInputs.Brake != 0.0f || NewInputs.Steering != 0.0f || NewInputs.Handbrake || NewInputs.Torque != 0.0f) )
+		{
+			WakeFromPassive();
+		}
 	}
 
 	// ** Debug ** //
@@ -322,14 +547,14 @@ protected: // Accessible by subclasses
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "VehicleSystemPlugin")
 	TArray<FDebugForce> DebugForces;
 
-	static void AddDebugTrace(FVehiclePhysicsPhysicsOutput& PhysicsOutput, const FHitResult& Trace)
+	static void AddDebugTrace(FAVS_VehiclePhysicsOutput& PhysicsOutput, const FHitResult& Trace)
 	{
 		#if !UE_BUILD_SHIPPING && !UE_BUILD_TEST
 		PhysicsOutput.DebugTraces.Add(Trace);
 		#endif
 	}
 
-	static void AddDebugForce(FVehiclePhysicsPhysicsOutput& PhysicsOutput, const FDebugForce& Force)
+	static void AddDebugForce(FAVS_VehiclePhysicsOutput& PhysicsOutput, const FDebugForce& Force)
 	{
 		#if !UE_BUILD_SHIPPING && !UE_BUILD_TEST
 		PhysicsOutput.DebugForces.Add(Force);
@@ -348,6 +573,7 @@ public:
 	// ** Overrides ** //
 
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
 	virtual void TickActor(float DeltaTime, enum ELevelTick TickType, FActorTickFunction& ThisTickFunction) override;
@@ -360,7 +586,16 @@ public:
 
 	// ** Physics Thread ** //
 
-	void AVS_PhysicsTick(float ChaosDelta, const FVehiclePhysicsPhysicsInput* PhysicsInput, FVehiclePhysicsPhysicsOutput& PhysicsOutput);
+	// Applies new wheel configs and queues this vehicle's wheel rays, must run before AVS_PhysicsTick in the same step
+	// Returns false if the wheel store does not match the input yet, the vehicle is not simulated this step
+	bool AVS_GatherWheelQueries(const FAVS_VehiclePhysicsInput& PhysicsInput, TConstArrayView<FAVS1_Wheel_Config> WheelConfigs,
+		TConstArrayView<TSharedPtr<const FAVS_TireTable, ESPMode::ThreadSafe>> TireTables, TConstArrayView<FAVS_WheelDynamicInput> Wheels, FAVS_WheelQueryBatch& QueryBatch);
+	// Anything that can move near the wheels, the surface grid only knows the static ground
+	bool AVS_HasDynamicObjectsNearWheels();
+	TArray<FOverlapResult> NearWheelOverlaps; // Reused by AVS_HasDynamicObjectsNearWheels
+	// Can run on any worker thread, only reads rigid bodies and writes forces to Forces
+	void AVS_PhysicsTick(float ChaosDelta, float GravityZ, const FAVS_VehiclePhysicsInput& PhysicsInput,
+		FAVS_VehiclePhysicsOutput& PhysicsOutput, const FAVS_WheelQueryBatch& QueryBatch, FAVS_ForceAccumulator& Forces);
 
 	// ** Passive / Rest ** //
 
@@ -373,6 +608,80 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - General", AdvancedDisplay)
 	bool PassiveTickGatekeeping = true;
 
+	// Passive vehicles that are at rest and whose body is asleep stop ticking and sending physics inputs entirely.
+	// They wake up on input, possession, a rigid body wake or hit, an incoming network state, WakeFromPassive,
+	// or when DeterminePassiveState turns false (checked every PassiveSleepCheckInterval). AVS_PassiveTick does not run while asleep
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - General", AdvancedDisplay)
+	bool PassiveSleep = false;
+
+	// Seconds between DeterminePassiveState checks while asleep
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - General", AdvancedDisplay, meta=(EditCondition="PassiveSleep", ClampMin="0.1"))
+	float PassiveSleepCheckInterval = 1.0f;
+
+	// Seconds a woken vehicle stays active before DeterminePassiveState is asked again
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - General", AdvancedDisplay, meta=(EditCondition="PassiveSleep"))
+	float PassiveWakeDuration = 2.0f;
+
+	// Leaves passive mode and restarts the tick of a sleeping vehicle
+	UFUNCTION(BlueprintCallable, Category = "Vehicle - General")
+	void WakeFromPassive();
+
+	// Enables contact modification on the VehicleMesh for games that modify its contacts from their own sim callback.
+	// Not needed for wheel collisions, those are filtered out before narrowphase
+	UPROPERTY(EditAnywhere, Category = "Vehicle - Physics", AdvancedDisplay)
+	bool UseContactModification = false;
+
+	// Distance to the closest local player view in meters after which wheel visuals update at WheelVisualFarRate
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - General", AdvancedDisplay)
+	float WheelVisualLODDistance = 60.0f;
+
+	// Wheel visual updates per second past WheelVisualLODDistance, 0 updates every frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - General", AdvancedDisplay)
+	float WheelVisualFarRate = 15.0f;
+
+	// Wheel visual updates per second while the vehicle is not rendered, 0 updates every frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - General", AdvancedDisplay)
+	float WheelVisualHiddenRate = 2.0f;
+
+	// Lowers the simulation detail of vehicles far from every player, player controlled vehicles and worlds without player views always use the full simulation
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Physics", AdvancedDisplay)
+	bool UseSimulationTiers = false;
+
+	// Distance in meters to the closest player view past which the Reduced tier is used
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Physics", AdvancedDisplay, meta=(EditCondition="UseSimulationTiers"))
+	float ReducedTierDistance = 150.0f;
+
+	// Distance in meters to the closest player view past which the Kinematic tier is used
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Physics", AdvancedDisplay, meta=(EditCondition="UseSimulationTiers"))
+	float KinematicTierDistance = 400.0f;
+
+	// Fraction of the tier distances a vehicle has to pass before it changes tier again, stops flickering at the edges
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Physics", AdvancedDisplay, meta=(EditCondition="UseSimulationTiers", ClampMin="0", ClampMax="0.5"))
+	float SimulationTierHysteresis = 0.1f;
+
+	// Distance multiplier for vehicles behind every player view
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Physics", AdvancedDisplay, meta=(EditCondition="UseSimulationTiers"))
+	float SimulationTierOutOfViewScale = 2.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vehicle - Physics")
+	EVehicleSimulationTier SimulationTier = EVehicleSimulationTier::Full;
+
+	// Wheels resting or rolling slowly on static ground solve their ray against the plane of the last trace instead of tracing again
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Physics", AdvancedDisplay)
+	bool UseContactCache = true;
+
+	// Distance in cm a wheel can move from its last real trace before it has to trace again
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Physics", AdvancedDisplay, meta=(EditCondition="UseContactCache", ClampMin="0", Units="cm"))
+	float ContactCacheTolerance = 5.0f;
+
+	// Physics steps a cached contact is used for before it is traced again, catches ground that changed under a parked wheel
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Physics", AdvancedDisplay, meta=(EditCondition="UseContactCache", ClampMin="1"))
+	int32 ContactCacheMaxSteps = 10;
+
+	// Raycast wheels read the world's baked surface grid before tracing, see UVehiclePhysicsSubsystem::SetSurfaceGrid
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Physics", AdvancedDisplay)
+	bool UseSurfaceGrid = true;
+
 	// Velocity (cm) at which the vehicle is considered moving, used for network rest state and passive mode
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Physics", AdvancedDisplay)
 	float RestVelocityThreshold = 25.0f;
@@ -405,6 +714,41 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
 	TArray<FVehicleGear> Gears;
 
+	// Gear selection, engine torque and differential run on the physics thread every step instead of using the Torque input
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission")
+	bool NativeDrivetrain = false;
+
+	// X: Engine RPM, Y: Multiplier of the gear torque. Baked into a table by UpdateDrivetrain
+	UPROPERTY(EditAnywhere, Category = "Vehicle - Transmission", meta=(EditCondition="NativeDrivetrain", XAxisName="RPM", YAxisName="Torque"))
+	FRuntimeFloatCurve EngineTorqueCurve;
+
+	// Converts cm/s to the speed unit used by Gears, 0.036 for km/h or 0.0224 for mph
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission", meta=(EditCondition="NativeDrivetrain"))
+	float GearSpeedScale = 0.036f;
+
+	// Seconds without drive torque while changing gear
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission", meta=(EditCondition="NativeDrivetrain"))
+	float ShiftTime = 0.2f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission", meta=(EditCondition="NativeDrivetrain"))
+	EVehicleDifferential Differential = EVehicleDifferential::Open;
+
+	// Share of the torque a limited slip differential sends to the wheels with the most grip
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle - Transmission", meta=(EditCondition="NativeDrivetrain && Differential==EVehicleDifferential::LimitedSlip", ClampMin="0.0", ClampMax="1.0"))
+	float LimitedSlipLocking = 0.5f;
+
+	// Native drivetrain gear, 1 is the first entry of Gears, 0 if there are no gears
+	UPROPERTY(BlueprintReadOnly, Category = "Vehicle - Transmission")
+	int32 CurrentGear = 0;
+
+	// Native drivetrain engine RPM
+	UPROPERTY(BlueprintReadOnly, Category = "Vehicle - Transmission")
+	float EngineRPM = 0.0f;
+
+	// Sends the current transmission settings to the physics thread, call after changing them at runtime
+	UFUNCTION(BlueprintCallable, Category = "VehicleSystemPlugin")
+	void UpdateDrivetrain();
+
 	UFUNCTION(BlueprintPure, Category = "VehicleSystemPlugin")
 	float GetSteeringSpeed(float OldSteering, float NewSteering)
 	{
@@ -0,0 +1,87 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "VehicleTireModel.generated.h"
+
+// Baked combined slip force surface, read by the physics thread and shared by every wheel using the same tire
+struct VEHICLESYSTEMPLUGIN_API FAVS_TireTable
+{
+	int32 Resolution = 0; // Samples per axis
+	float SlipRange = 0.0f; // Table covers -SlipRange to SlipRange on both axes
+	float InvStep = 0.0f;
+	TArray<FVector2f> Forces; // Traction per unit of friction, row major with slip Y as the row
+
+	// Bilinear lookup, slip outside the table is clamped to its edge
+	FVector2f Evaluate(float SlipX, float SlipY) const
+	{
+		const float U = (FMath::Clamp(SlipX, -SlipRange, SlipRange) + SlipRange) * InvStep;
+		const float V = (FMath::Clamp(SlipY, -SlipRange, SlipRange) + SlipRange) * InvStep;
+		const int32 X0 = FMath::Min(static_cast<int32>(U), Resolution - 2);
+		const int32 Y0 = FMath::Min(static_cast<int32>(V), Resolution - 2);
+		const float AlphaX = U - X0;
+		const float AlphaY = V - Y0;
+
+		const FVector2f* Row0 = &Forces[Y0 * Resolution + X0];
+		const FVector2f* Row1 = Row0 + Resolution;
+		return FMath::Lerp(FMath::Lerp(Row0[0], Row0[1], AlphaX), FMath::Lerp(Row1[0], Row1[1], AlphaX), AlphaY);
+	}
+};
+
+/**
+ * Tire curves from Pacejka magic formula parameters, baked into a lookup table when loaded or edited.
+ * Slip is in AVS units, both curves are stretched so their peak force lands at a slip of 1.
+ * Wheels without a tire model keep the built-in friction circle.
+ */
+UCLASS(BlueprintType)
+class VEHICLESYSTEMPLUGIN_API UVehicleTireModel : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Magic formula B, how quickly force builds up with slip
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tire|Longitudinal", meta=(ClampMin="0.1"))
+	float LongStiffness = 10.0f;
+	// Magic formula C, shape of the curve after the peak
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tire|Longitudinal", meta=(ClampMin="1.0", ClampMax="2.0"))
+	float LongShape = 1.65f;
+	// Magic formula D, peak force relative to the tire friction
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tire|Longitudinal", meta=(ClampMin="0.0"))
+	float LongPeak = 1.0f;
+	// Magic formula E, sharpness of the peak
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tire|Longitudinal", meta=(ClampMax="1.0"))
+	float LongCurvature = 0.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tire|Lateral", meta=(ClampMin="0.1"))
+	float LatStiffness = 8.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tire|Lateral", meta=(ClampMin="1.0", ClampMax="2.0"))
+	float LatShape = 1.3f;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tire|Lateral", meta=(ClampMin="0.0"))
+	float LatPeak = 1.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tire|Lateral", meta=(ClampMax="1.0"))
+	float LatCurvature = -0.5f;
+
+	// Largest slip stored in the table, bigger slip uses the table edge
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tire|Table", AdvancedDisplay, meta=(ClampMin="1.0"))
+	float SlipRange = 4.0f;
+	// Samples per axis, odd counts keep zero slip on a sample
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tire|Table", AdvancedDisplay, meta=(ClampMin="9", ClampMax="129"))
+	int32 TableResolution = 33;
+
+	// Baked table, wheels pick it up when their config is sent to the physics thread
+	TSharedPtr<const FAVS_TireTable, ESPMode::ThreadSafe> GetTable() const { return Table; }
+
+	virtual void PostInitProperties() override;
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	TSharedPtr<const FAVS_TireTable, ESPMode::ThreadSafe> Table;
+
+	void BakeTable();
+};
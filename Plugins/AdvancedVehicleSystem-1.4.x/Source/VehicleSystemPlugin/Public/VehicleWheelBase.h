@@ -5,15 +5,34 @@
 
 #include "CoreMinimal.h"
 #include "Engine/HitResult.h"
+#include "Chaos/ChaosEngineInterface.h"
 #include "Components/SceneComponent.h"
 #include "VehicleWheelBase.generated.h"
 
+class UVehicleTireModel;
+
 UENUM(BlueprintType)
 enum class EWheelMode : uint8
 {
 	Raycast, Physics
 };
 
+UENUM(BlueprintType)
+enum class EWheelContactModel : uint8
+{
+	SingleRay,		// One ray through the wheel center
+	MultiRay,		// Rays spread along the tire's profile, finds curbs and edges in front of or behind the center
+	SphereSweep		// Sphere swept down to the bottom of the wheel, most accurate on rough ground and the most expensive
+};
+
+UENUM(BlueprintType)
+enum class EVehicleSimulationTier : uint8
+{
+	Full,		// Every wheel traced every step, full slip and tire model
+	Reduced,	// Half of the wheels traced per step, no slip relaxation or substeps, default friction curve
+	Kinematic	// One wheel traced per step, the others follow their last ground plane
+};
+
 USTRUCT(BlueprintType)
 struct FDebugForce
 {
@@ -57,15 +76,26 @@ struct FAVS_Inputs // Input data to sent to physics thread each game tick
 	FAVS_Inputs(){}
 };
 
-USTRUCT()
-struct FAVS1_Wheel_State // Physics thread wheel state
+USTRUCT(BlueprintType)
+struct FAVS_WheelContact // Compact wheel contact, full hit details are fetched on demand with UVehicleWheelBase::GetLastTrace
 {
 	GENERATED_BODY()
 
-	FVector2D Slip = FVector2D(0.0f, 0.0f);
-	float AngularVelocity = 0.0f;
-	
-	FAVS1_Wheel_State(){}
+	UPROPERTY(BlueprintReadOnly, Category = "Vehicle System Plugin|Wheel State")
+	bool HasContact = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Vehicle System Plugin|Wheel State")
+	TEnumAsByte<EPhysicalSurface> SurfaceType = SurfaceType_Default;
+
+	// Distance from the trace start in cm
+	UPROPERTY(BlueprintReadOnly, Category = "Vehicle System Plugin|Wheel State")
+	float Distance = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Vehicle System Plugin|Wheel State")
+	FVector ImpactPoint = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Vehicle System Plugin|Wheel State")
+	FVector ImpactNormal = FVector::UpVector;
 };
 
 USTRUCT(BlueprintType)
@@ -73,9 +103,9 @@ struct FAVS1_Wheel_Output // Data output from the physics thread
 {
 	GENERATED_BODY()
 
-	// Last trace
+	// Last contact
 	UPROPERTY(BlueprintReadOnly, Category = "Vehicle System Plugin|Wheel State")
-	FHitResult LastTrace;
+	FAVS_WheelContact Contact;
 	
 	// Wheel's angular velocity in Rad/s
 	UPROPERTY(BlueprintReadOnly, Category = "Vehicle System Plugin|Wheel State")
@@ -88,8 +118,13 @@ struct FAVS1_Wheel_Output // Data output from the physics thread
 	FAVS1_Wheel_Output(){}
 };
 
+struct FAVS_WheelDynamicInput // Per wheel data sent to the physics thread each game tick
+{
+	bool IsLocked = false;
+};
+
 USTRUCT(BlueprintType)
-struct FAVS1_Wheel_Config // Configuration data to sent to physics thread each game tick //TODO: Split into WheelConfig & SimulationConfig
+struct FAVS1_Wheel_Config // Configuration data sent to the physics thread when it changes, see UVehicleWheelBase::MarkWheelConfigDirty
 {
 	GENERATED_BODY()
 
@@ -97,9 +132,6 @@ struct FAVS1_Wheel_Config // Configuration data to sent to physics thread each g
 	UPROPERTY(Transient, BlueprintReadOnly, Category = "Vehicle System Plugin|Wheel State")
 	FTransform WheelLocalTransform = FTransform();
 
-	UPROPERTY(Transient)
-	bool isLocked = false;
-
 	// Wheel physics object
 	UPROPERTY()
 	UPrimitiveComponent* WheelPrim = nullptr;
@@ -113,6 +145,22 @@ struct FAVS1_Wheel_Config // Configuration data to sent to physics thread each g
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Wheel - Config|Wheel|Raycast Settings", meta=(EditCondition="WheelMode==EWheelMode::Raycast"))
 	TArray<AActor*> TraceIgnoreActors;
 
+	// How the ground is found, only used by vehicles in the Full simulation tier, lower tiers always use a single ray
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Wheel - Config|Wheel|Raycast Settings", meta=(EditCondition="WheelMode==EWheelMode::Raycast"))
+	EWheelContactModel ContactModel = EWheelContactModel::SingleRay;
+
+	// Rays per wheel with the MultiRay contact model, even counts are rounded up so one ray stays at the center
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Wheel - Config|Wheel|Raycast Settings", meta=(EditCondition="WheelMode==EWheelMode::Raycast && ContactModel==EWheelContactModel::MultiRay", ClampMin="3", ClampMax="9"))
+	int32 ContactRayCount = 3;
+
+	// How far along the tire the outer rays are, as a fraction of the wheel radius
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Wheel - Config|Wheel|Raycast Settings", meta=(EditCondition="WheelMode==EWheelMode::Raycast && ContactModel==EWheelContactModel::MultiRay", ClampMin="0.1", ClampMax="0.95"))
+	float ContactRaySpread = 0.7f;
+
+	// Radius of the swept sphere in cm, its bottom follows the bottom of the wheel, clamped to the wheel radius
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Wheel - Config|Wheel|Raycast Settings", meta=(EditCondition="WheelMode==EWheelMode::Raycast && ContactModel==EWheelContactModel::SphereSweep", ClampMin="1", Units="cm"))
+	float ContactSweepRadius = 15.0f;
+
 	// (Rim+Tire) Wheel Mass in Kg
 	// Used in wheel simulation, not the actual mass of the wheel mesh physics object
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Wheel - Config|Wheel", meta=(Units="Kg"))
@@ -129,6 +177,14 @@ struct FAVS1_Wheel_Config // Configuration data to sent to physics thread each g
 	// Friction Coefficient
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Wheel - Config|Wheel")
 	FVector2D TireFriction = FVector2D(1.4f, 1.4f);
+
+	// Baked tire curves used instead of the built-in friction circle, can be shared by many wheels
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Wheel - Config|Wheel")
+	UVehicleTireModel* TireModel = nullptr;
+
+	// Slip integration steps per physics step, lets stiff tires stay stable without raising the physics rate
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Wheel - Config|Wheel", AdvancedDisplay, meta=(ClampMin="1", ClampMax="16"))
+	int32 SlipSubsteps = 1;
 	
 	// Wheel receives torque
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Wheel - Config|Drive/Steer")
@@ -202,6 +258,16 @@ class VEHICLESYSTEMPLUGIN_API UVehicleWheelBase : public USceneComponent
 private:
 	float CurAngVel = 0.0f;
 
+	// Incremented whenever WheelConfig changes, the vehicle only resends configs with a new version
+	int32 WheelConfigVersion = 0;
+
+	// WheelConfig as of the last version, catches members set directly (e.g. from Blueprint) without MarkWheelConfigDirty
+	FAVS1_Wheel_Config LastWheelConfig;
+	int32 LastWheelConfigVersion = -1;
+
+	// Blueprint implements Tick, the only reason for this component to tick
+	bool HasBlueprintTick = false;
+
 protected: // Accessible by subclasses
 	virtual void BeginPlay() override;
 
@@ -232,7 +298,10 @@ protected: // Accessible by subclasses
 	
 public:	
 	UVehicleWheelBase();
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Spins and places the wheel mesh, called by the owning vehicle for all of its wheels in one pass.
+	// DeltaTime is the time since the last update, which can span several frames for far or hidden vehicles
+	void UpdateVisuals(float DeltaTime);
 
 	// ** Config ** //
 
@@ -244,15 +313,47 @@ public:
 	UStaticMesh* WheelStaticMesh;
 	
 	// Current configuration of this wheel, this is the data sent to the physics simulation
+	// Members edited directly are found by DetectWheelConfigChange on the next tick
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Wheel - Config", meta=(ShowOnlyInnerProperties))
 	FAVS1_Wheel_Config WheelConfig;
 
+	// Sends WheelConfig to the physics thread on the next tick
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Wheel - Config")
+	void MarkWheelConfigDirty() { ++WheelConfigVersion; }
+
+	int32 GetWheelConfigVersion() const { return WheelConfigVersion; }
+
+	// Compares WheelConfig with the last version and marks it dirty if it was edited directly, called by the vehicle every tick
+	void DetectWheelConfigChange();
+
+	// Replace the whole wheel configuration
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Wheel - Config")
+	void SetWheelConfig(const FAVS1_Wheel_Config& NewConfig)
+	{
+		const FTransform LocalTransform = WheelConfig.WheelLocalTransform; // Cached at runtime, not part of the user config
+		WheelConfig = NewConfig;
+		WheelConfig.WheelLocalTransform = LocalTransform;
+		WheelConfig.CalculateConstants();
+		MarkWheelConfigDirty();
+	}
+
 	// Update this wheel's mass (Rim+Tire) in Kg
 	UFUNCTION(BlueprintCallable, Category = "Vehicle Wheel - Config")
 	void SetRaycastWheelMass(float NewMass)
 	{
 		WheelConfig.WheelMass = NewMass;
 		WheelConfig.CalculateConstants(); // Recalculate inertia
+		MarkWheelConfigDirty();
+	}
+
+	// Update the suspension, length in cm, strength in N/mm, damping in kNs/m
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Wheel - Config")
+	void SetSuspension(float NewSpringLength, float NewSpringStrength, float NewSpringDamping)
+	{
+		WheelConfig.SpringLength = NewSpringLength;
+		WheelConfig.SpringStrength = NewSpringStrength;
+		WheelConfig.SpringDamping = NewSpringDamping;
+		MarkWheelConfigDirty();
 	}
 
 	/** Creates a constraint between the skeletal mesh bone and this wheel's collision or mesh component */
@@ -269,8 +370,16 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "Vehicle System Plugin|Wheel State")
 	FAVS1_Wheel_Output WheelData;
 
-	UPROPERTY()
-	FRotator WheelRotation;
+	// Visual spin of the wheel mesh in radians, wrapped
+	float WheelSpinAngle = 0.0f;
+
+	// Last relative transform given to the wheel mesh, unchanged transforms are not applied again
+	FVector LastVisualLocation = FVector::ZeroVector;
+	FQuat LastVisualRotation = FQuat::Identity;
+	bool HasVisualTransform = false;
+
+	FHitResult CachedLastTrace;
+	uint64 CachedLastTraceFrame = 0;
 
 	UPROPERTY(BlueprintReadOnly, Category = "Vehicle System Plugin|Wheel State")
 	UPrimitiveComponent* WheelMeshComponent;
@@ -297,13 +406,18 @@ public:
 		WheelMeshComponent = NewComponent;
 		WheelConfig.WheelPrim = NewComponent;
 		UpdateWheelRadius();
+		MarkWheelConfigDirty();
 	}
 
 	UFUNCTION(BlueprintCallable, Category = "Vehicle System Plugin|Wheel State")
 	void ResetWheelCollisions();
 
 	UFUNCTION(BlueprintPure, Category = "Vehicle System Plugin|Wheel State")
-	bool GetHasContact() { return WheelData.LastTrace.bBlockingHit; }
+	bool GetHasContact() { return WheelData.Contact.HasContact; }
+
+	// Full hit result of the last contact, traced again on the game thread when asked for (cached for the frame)
+	UFUNCTION(BlueprintCallable, Category = "Vehicle System Plugin|Wheel State")
+	FHitResult GetLastTrace();
 
 	UFUNCTION(BlueprintPure, Category = "Vehicle System Plugin|Wheel State")
 	EWheelMode GetWheelMode(){ return WheelConfig.WheelMode; }
@@ -311,6 +425,9 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Vehicle System Plugin|Wheel State")
 	bool GetIsAttached() const { return isAttached; }
 
+	UFUNCTION(BlueprintPure, Category = "Vehicle System Plugin|Wheel State")
+	bool GetIsLocked() const { return isLocked; }
+
 	UFUNCTION(BlueprintCallable, Category = "Vehicle System Plugin|Wheel State")
 	void SetIsSimulatingSuspension(bool NewSimulate) { SimulateSuspension = NewSimulate; }
 
@@ -333,7 +450,7 @@ public:
 	void SetPassiveMode(bool NewPassive)
 	{
 		if( NewPassive != PassiveMode ) PassiveStateChanged(NewPassive);
-		if( !NewPassive ) { SetComponentTickEnabled(true); }
+		SetComponentTickEnabled(HasBlueprintTick && !NewPassive); // Passive wheels do not tick at all
 		PassiveMode = NewPassive;
 	}
 
@@ -0,0 +1,81 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FAVS_TireTable;
+
+/**
+ * Contacts of one vehicle laid out for the wheel force kernels, one lane per wheel with a trace hit.
+ * Columns are padded to a multiple of GroupWidth with neutral lanes so the vector path has no scalar tail.
+ */
+struct FAVS_WheelKernelData
+{
+	static constexpr int32 GroupWidth = 4;
+
+	// ** Suspension inputs ** //
+	TArray<float> TraceDistances; // cm from the top of the wheel to the hit
+	TArray<float> SpringLengths; // cm
+	TArray<float> Radii; // cm
+	TArray<float> SpringStrengths; // N/mm
+	TArray<float> SpringDampings; // kNs/m
+	TArray<float> CompressionVelocities; // m/s, positive while compressing
+	TArray<float> ImpactTilts; // 1 = upright relative to the impact normal, 0 = sideways
+
+	// ** Suspension outputs ** //
+	TArray<float> CurrentSpringLengths; // cm
+	TArray<float> SuspensionForces; // N along the impact normal
+
+	// ** Traction inputs ** //
+	TArray<float> SlipsX; // Interpolated slip, not normalized
+	TArray<float> SlipsY;
+	TArray<float> FrictionsX; // Tire friction * surface friction
+	TArray<float> FrictionsY;
+	TArray<const FAVS_TireTable*> TireTables; // nullptr uses the built-in friction circle
+
+	// ** Traction outputs ** //
+	TArray<float> TractionsX; // Share of the suspension force applied along the forward axis
+	TArray<float> TractionsY; // Share of the suspension force applied along the right axis
+
+	// Wheel store index of each lane, INDEX_NONE for padding
+	TArray<int32> WheelIndices;
+
+	int32 Num() const { return WheelIndices.Num(); }
+
+	// Clears every column and keeps the allocations
+	void Reset();
+
+	// Adds a zeroed lane for WheelIndex, returns the lane
+	int32 AddLane(int32 WheelIndex);
+
+	// Fills the last group with neutral lanes, call once every lane is added
+	void PadToGroupWidth();
+};
+
+/**
+ * Suspension and traction math shared by every raycast wheel.
+ * The vector path processes GroupWidth wheels per iteration, the scalar path is the reference implementation.
+ */
+struct FAVS_WheelKernel
+{
+	static constexpr float TiltFalloffStart = 0.5f; // Force starts dropping off here
+	static constexpr float TiltFalloffEnd = 0.1f; // Zero force here
+
+	// Spring length and suspension force of every lane, AntiGravityN is added while the spring is over compressed
+	static void Suspension(FAVS_WheelKernelData& Data, float AntiGravityN);
+	static void SuspensionScalar(FAVS_WheelKernelData& Data, float AntiGravityN);
+	static void SuspensionVector(FAVS_WheelKernelData& Data, float AntiGravityN);
+
+	// Friction circle, turns the slip of every lane into traction coefficients. Lanes with a tire table are left to TractionTables
+	static void Traction(FAVS_WheelKernelData& Data);
+	static void TractionScalar(FAVS_WheelKernelData& Data);
+	static void TractionVector(FAVS_WheelKernelData& Data);
+
+	// Replaces the friction circle result of lanes that have a baked tire table
+	static void TractionTables(FAVS_WheelKernelData& Data);
+
+	// Tolerance between the scalar and vector results of a lane, used by avs.WheelKernelValidate
+	static bool ValuesMatch(float Scalar, float Vector);
+};
@@ -0,0 +1,84 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "Engine/EngineTypes.h"
+#include "Engine/HitResult.h"
+
+class UPhysicalMaterial;
+class UPrimitiveComponent;
+
+struct FAVS_WheelRay // Wheel ray queued for the batched scene query stage
+{
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	ECollisionChannel TraceChannel = ECC_Vehicle;
+
+	// Sweeps a sphere of this radius instead of a line when above 0, its bottom runs from Start to End
+	float SweepRadius = 0.0f;
+	// Added to the hit distance to get the distance of the wheel's bottom, so the hits of all rays of a wheel compare as if they were its center ray.
+	// Positive for rays off the center, where the tire's circle is above its bottom
+	float DistanceOffset = 0.0f;
+
+	// Owned by the wheel state on the physics thread, must stay valid until the batch is executed
+	const FCollisionQueryParams* QueryParams = nullptr;
+};
+
+struct FAVS_WheelHit // Compact wheel query result, only what the suspension and friction need
+{
+	bool bBlockingHit = false;
+	float Distance = 0.0f;
+	FVector Location = FVector::ZeroVector;
+	FVector ImpactPoint = FVector::ZeroVector;
+	FVector ImpactNormal = FVector::UpVector;
+	TWeakObjectPtr<UPhysicalMaterial> PhysMaterial;
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+	bool bStaticComponent = false; // Component can never move, so its plane stays valid until the wheel moves away
+	bool bSweepHit = false; // Contact of a swept sphere, its plane does not match the wheel's center line and is never reused
+	float DistanceOffset = 0.0f; // FAVS_WheelRay::DistanceOffset of the ray that made this hit, kept when solving against the plane
+
+	// Expands the compact hit back into a full hit result (game thread output and debug only)
+	FHitResult ToHitResult(const FAVS_WheelRay& Ray) const;
+
+	// Intersects the ray with the plane of this hit instead of the scene, OutHit has no blocking hit if it misses.
+	// The ray's own DistanceOffset is added again, Start/End are the wheel's center ray
+	bool SolveAgainstPlane(const FVector& Start, const FVector& End, FAVS_WheelHit& OutHit) const;
+};
+
+// Collects every wheel ray of a physics step and resolves them in a single pass
+struct FAVS_WheelQueryBatch
+{
+	TArray<FAVS_WheelRay> Rays;
+	TArray<FAVS_WheelHit> Hits;
+
+	// Keeps allocations, the batch is reused every physics step
+	void Reset()
+	{
+		Rays.Reset();
+		Hits.Reset();
+	}
+
+	// Returns the index used to fetch the hit after Execute
+	int32 AddRay(const FVector& Start, const FVector& End, ECollisionChannel TraceChannel, const FCollisionQueryParams* QueryParams,
+		float SweepRadius = 0.0f, float DistanceOffset = 0.0f);
+
+	// Runs all queued rays against the scene, fills Hits with one entry per ray
+	void Execute(const UWorld* World);
+
+	const FAVS_WheelRay& GetRay(int32 Index) const { return Rays[Index]; }
+	const FAVS_WheelHit& GetHit(int32 Index) const { return Hits[Index]; }
+
+	// NumRays rays spread along Forward over Spread (fraction of Radius) on each side of the center ray, returns the first index.
+	// Each ray is offset by how far the tire's circle is above its bottom there, see FAVS_WheelRay::DistanceOffset
+	int32 AddProfileRays(const FVector& Start, const FVector& End, const FVector& Forward, float Radius, float Spread, int32 NumRays,
+		ECollisionChannel TraceChannel, const FCollisionQueryParams* QueryParams);
+
+	// Closest blocking hit of Count rays added one after another, the suspension is pushed by whichever reaches the ground first
+	const FAVS_WheelHit& GetClosestHit(int32 FirstIndex, int32 Count) const;
+
+	// Trace params shared by all wheel rays, built once per wheel instead of every trace
+	static FCollisionQueryParams MakeQueryParams(const AActor* Vehicle, const TArray<AActor*>& IgnoreActors);
+};
@@ -0,0 +1,82 @@
+// Copyright 2019-2024 Overtorque Creations LLC. All Rights Reserved.
+// Unauthorized copying of this file, via any medium is strictly prohibited
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "VehicleWheelBase.h"
+#include "VehicleWheelQuery.h"
+#include "VehicleTireModel.h"
+
+/**
+ * Physics thread wheel data of one vehicle, stored as one array per field.
+ * Owned by the vehicle and kept between steps, the hot loop reads the columns it needs instead of copying FAVS1_Wheel_Config.
+ */
+struct FAVS_WheelStore
+{
+	enum EWheelFlags : uint8
+	{
+		WF_Driving			= 1 << 0,
+		WF_Steerable		= 1 << 1,
+		WF_InvertTorque		= 1 << 2,
+		WF_InvertSteering	= 1 << 3,
+		WF_Braking			= 1 << 4,
+		WF_Handbrake		= 1 << 5,
+		WF_Locked			= 1 << 6, // Dynamic, set every step from FAVS_WheelDynamicInput
+	};
+
+	// ** Config ** //
+
+	TArray<FTransform> LocalTransforms; // Relative to the vehicle
+	TArray<float> SpringLengths; // cm
+	TArray<float> SpringStrengths; // N/mm
+	TArray<float> SpringDampings; // kNs/m
+	TArray<float> Radii; // cm
+	TArray<float> Inertias; // kg*m^2
+	TArray<float> BrakeTorques; // Nm
+	TArray<float> RollingResistances;
+	TArray<float> MaxSteeringAngles; // Degrees
+	TArray<FVector2D> TireFrictions;
+	TArray<uint8> SlipSubsteps;
+	TArray<TSharedPtr<const FAVS_TireTable, ESPMode::ThreadSafe>> TireTables; // Held so an edited tire model does not free a table mid step
+	TArray<uint8> Flags; // EWheelFlags
+	TArray<EWheelMode> WheelModes;
+	TArray<TEnumAsByte<ECollisionChannel>> TraceChannels;
+	TArray<EWheelContactModel> ContactModels;
+	TArray<uint8> ContactRayCounts;
+	TArray<float> ContactRaySpreads; // Fraction of the radius
+	TArray<float> ContactSweepRadii; // cm, already clamped to the wheel radius
+	TArray<UPrimitiveComponent*> WheelPrims;
+
+	// Trace params, only rebuilt when the ignore list changes
+	TArray<FCollisionQueryParams> QueryParams;
+	TArray<TArray<AActor*>> QueryIgnoreActors;
+	TArray<bool> QueryParamsBuilt;
+
+	// ** State ** //
+
+	TArray<FVector2D> Slips;
+	TArray<float> AngularVelocities; // Rad/s
+	TArray<FTransform> WorldTransforms; // Current physics step, including steering
+	TArray<int32> QueryIndices; // First ray of each wheel in the current step's query batch, INDEX_NONE when not traced this step
+	TArray<uint8> QueryCounts; // Rays of each wheel in the query batch, more than one with the MultiRay contact model
+	TArray<FAVS_WheelHit> LastHits; // Result of the last real trace, its plane stands in for the scene while the wheel is not traced
+	TArray<FAVS_WheelHit> SolvedHits; // Current step's hit of wheels that were not traced
+	TArray<FVector> LastTraceLocations; // Wheel location of the last real trace, the contact cache expires once the wheel leaves it
+	TArray<uint32> LastTraceSteps; // PhysicsStepCount of the last real trace
+
+	// Version of the game thread configs currently in the columns, 0 until the first configs arrive
+	int32 ConfigVersion = 0;
+
+	int32 Num() const { return Flags.Num(); }
+
+	// Resizes every column, new wheels start with default state
+	void SetNum(int32 NumWheels);
+
+	// Copies the simulation relevant fields of Config into the columns of WIndex, TireTable is Config.TireModel's table resolved by the game thread
+	void SetWheelConfig(int32 WIndex, const FAVS1_Wheel_Config& Config, const TSharedPtr<const FAVS_TireTable, ESPMode::ThreadSafe>& TireTable, const AActor* Vehicle);
+
+	bool HasFlag(int32 WIndex, EWheelFlags Flag) const { return (Flags[WIndex] & Flag) != 0; }
+	void SetFlag(int32 WIndex, EWheelFlags Flag, bool Value) { Flags[WIndex] = static_cast<uint8>(Value ? (Flags[WIndex] | Flag) : (Flags[WIndex] & ~Flag)); }
+};
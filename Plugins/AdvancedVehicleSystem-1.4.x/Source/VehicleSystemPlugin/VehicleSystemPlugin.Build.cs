@@ -10,7 +10,7 @@ public class VehicleSystemPlugin : ModuleRules
 		//IncludeOrderVersion = EngineIncludeOrderVersion.Latest;
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 	
-		PublicDependencyModuleNames.AddRange(new string[] { "Core", });
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "NetCore", });
 		PrivateDependencyModuleNames.AddRange(new string[] { "Projects", "CoreUObject", "Engine", "Chaos", });
 
 		//Required for Chaos physics callbacks